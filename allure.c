@@ -0,0 +1,48 @@
+#include <xc.h>
+#include "allure.h"
+
+// facteur(i) = max(ALLURE_MIN, ALLURE_MAX / sqrt(1 + i / 6))
+static const unsigned int allureTable[ALLURE_NB] = {
+    320, 296, 277, 261, 248, 236, 226, 217,
+    209, 202, 196, 192, 192, 192, 192, 192
+};
+
+static int effort;              // |droite - gauche| moyen, fronts/s
+static int moyenne;             // position moyenne
+static long variance;
+static unsigned int facteur;
+
+void allure_init(void) {
+    effort = 0;
+    moyenne = 0;
+    variance = 0;
+    facteur = ALLURE_MIN;
+}
+
+void allure_calculer(int position, int differentiel) {
+    long ecart;
+    unsigned int indice, cible;
+
+    if (differentiel < 0) differentiel = -differentiel;
+    effort += (differentiel - effort) >> ALLURE_FENETRE;
+    moyenne += (position - moyenne) >> ALLURE_FENETRE;
+    ecart = (long) position - moyenne;
+    variance += (ecart * ecart - variance) >> ALLURE_FENETRE;
+
+    indice = (unsigned int) (effort >> ALLURE_DECALAGE_EFFORT)
+            + (unsigned int) (variance >> ALLURE_DECALAGE_VAR);
+    if (indice >= ALLURE_NB) indice = ALLURE_NB - 1;
+    cible = allureTable[indice];
+
+    if (cible > facteur + ALLURE_ACCEL) {
+        facteur += ALLURE_ACCEL;
+    } else if (cible + ALLURE_FREIN < facteur) {
+        facteur -= ALLURE_FREIN;
+    } else {
+        facteur = cible;
+    }
+}
+
+unsigned int allure_facteur(void) {
+    return facteur;
+}
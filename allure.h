@@ -0,0 +1,45 @@
+#ifndef ALLURE_H
+#define ALLURE_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Vitesse de base selon la courbure de la piste
+//
+// A chaque boucle externe, la courbure locale est estimée sur une fenêtre
+// glissante d'environ 2^ALLURE_FENETRE boucles (moyennes exponentielles) :
+//   - effort de direction : écart moyen des consignes |droite - gauche| ;
+//   - variance de la position de la ligne.
+// Leur somme pondérée donne un indice de 0 (ligne droite) à
+// ALLURE_NB - 1 (épingle). La table allureTable donne pour chaque indice
+// le facteur de vitesse x 256, de ALLURE_MAX à ALLURE_MIN, calculé pour
+// une accélération latérale constante (vitesse en 1 / racine de la
+// courbure) :
+//   facteur(i) = max(ALLURE_MIN, ALLURE_MAX / sqrt(1 + i / 6))
+//
+// Le facteur appliqué suit celui de la table en montant d'au plus
+// ALLURE_ACCEL et en descendant d'au plus ALLURE_FREIN par boucle.
+///////////////////////////////////////////////////////////////////////////////
+
+#define ALLURE_MIN          192     // x 256 : 0,75 x la vitesse de référence
+#define ALLURE_MAX          320     // x 256 : 1,25 x
+#define ALLURE_NB           16      // entrées de la table
+#define ALLURE_FENETRE      3       // moyennes sur 8 boucles externes
+
+// Indice = effort >> ALLURE_DECALAGE_EFFORT + variance >> ALLURE_DECALAGE_VAR
+#define ALLURE_DECALAGE_EFFORT  7   // 128 fronts/s d'écart par indice
+#define ALLURE_DECALAGE_VAR     11  // 2048 (unités de position)² par indice
+
+// Variation du facteur par boucle externe (4 ms), x 256
+#define ALLURE_ACCEL        1       // 0,75 à 1,25 en 0,5 s
+#define ALLURE_FREIN        4       // 1,25 à 0,75 en 0,13 s
+
+// Au départ de la course : vitesse minimale, moyennes à zéro
+void allure_init(void);
+
+// A chaque boucle externe : position mesurée et écart des consignes
+// droite - gauche de la boucle précédente, en fronts/s
+void allure_calculer(int position, int differentiel);
+
+// Facteur de vitesse à appliquer aux consignes, x 256
+unsigned int allure_facteur(void);
+
+#endif
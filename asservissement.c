@@ -0,0 +1,100 @@
+#include <xc.h>
+#include "iut_pwm.h"
+#include "iut_codeurs.h"
+#include "asservissement.h"
+
+struct roue {
+    unsigned int consigne;      // fronts/s
+    int anticipation;           // rc calculé par le modèle
+    long integrale;             // rc x 256
+    unsigned int rc;            // appliqué au moteur
+};
+
+static struct roue roues[2];    // indices CODEUR_DROIT, CODEUR_GAUCHE
+static unsigned char kp = ASSERV_KP_Q8;
+static unsigned char ki = ASSERV_KI_Q8;
+
+// Inversion du modèle : une division, seulement quand la consigne change
+static void anticiper(struct roue *r, unsigned int consigne) {
+    if (consigne == r->consigne) return;
+    r->consigne = consigne;
+    r->anticipation = consigne
+            ? MOTEUR_MORT + (int) (((unsigned long) consigne << 8) / MOTEUR_GAIN_Q8)
+            : 0;
+}
+
+static unsigned int corriger(struct roue *r, unsigned int mesure) {
+    int rc;
+#ifndef BOUCLE_OUVERTE
+    long erreur, correction;
+    signed char sature;
+
+    if (r->consigne == 0) {
+        r->integrale = 0;
+        r->rc = 0;
+        return 0;
+    }
+    erreur = (long) r->consigne - (long) mesure;
+    // correction totale (P + I) bornée autour de l'anticipation
+    correction = ((erreur * kp) >> 8) + (r->integrale >> 8);
+    sature = 0;
+    if (correction >= ASSERV_CORRECTION_MAX) {
+        correction = ASSERV_CORRECTION_MAX;
+        sature = 1;
+    } else if (correction <= -ASSERV_CORRECTION_MAX) {
+        correction = -ASSERV_CORRECTION_MAX;
+        sature = -1;
+    }
+    rc = r->anticipation + (int) correction;
+    if (rc >= ASSERV_RC_MAX) sature = 1;
+    if (rc <= 0) sature = -1;
+
+    // intégrale gelée si la sortie sature dans le sens de l'erreur
+    if (!(sature > 0 && erreur > 0) && !(sature < 0 && erreur < 0)) {
+        r->integrale += erreur * ki;
+    }
+#else
+    (void) mesure;
+    rc = r->anticipation;
+#endif
+    if (rc < 0) rc = 0;
+    if (rc > ASSERV_RC_MAX) rc = ASSERV_RC_MAX;
+    r->rc = (unsigned int) rc;
+    return r->rc;
+}
+
+void asserv_init(void) {
+    asserv_arreter();
+}
+
+void asserv_gains(unsigned char p, unsigned char i) {
+    kp = p;
+    ki = i;
+}
+
+void asserv_consigne(unsigned int droite, unsigned int gauche) {
+    anticiper(&roues[CODEUR_DROIT], droite);
+    anticiper(&roues[CODEUR_GAUCHE], gauche);
+}
+
+void asserv_calculer(void) {
+    pwm_setdc1(corriger(&roues[CODEUR_DROIT], codeurs_vitesse(CODEUR_DROIT)));
+    pwm_setdc2(corriger(&roues[CODEUR_GAUCHE], codeurs_vitesse(CODEUR_GAUCHE)));
+}
+
+void asserv_arreter(void) {
+    unsigned char n;
+
+    for (n = 0; n < 2; n++) {
+        roues[n].consigne = 0;
+        roues[n].anticipation = 0;
+        roues[n].integrale = 0;
+        roues[n].rc = 0;
+    }
+    pwm_setdc1(0);
+    pwm_setdc2(0);
+}
+
+unsigned int asserv_rc(unsigned char roue) {
+    return roues[roue].rc;
+}
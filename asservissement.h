@@ -0,0 +1,69 @@
+#ifndef ASSERVISSEMENT_H
+#define ASSERVISSEMENT_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Asservissement de vitesse des roues (boucle interne)
+//
+// suiviLigne() (boucle externe, tous les ASSERV_DIVISEUR tics) fixe une
+// consigne de vitesse par roue ; asserv_calculer() (boucle interne, à
+// chaque tic) règle le rapport cyclique de chaque moteur pour la suivre,
+// d'après la vitesse mesurée par les codeurs (iut_codeurs.h).
+//
+// Commande = anticipation + correcteur PI en virgule fixe :
+//   - anticipation : modèle statique du moteur, vitesse = (rc - MOTEUR_MORT)
+//     x MOTEUR_GAIN, inversé une fois par changement de consigne ;
+//   - PI : gains en Q8 (256 = 1 unité de rapport cyclique par front/s),
+//     intégrale gelée quand la correction ou le rapport cyclique sature
+//     dans le sens de l'erreur (anti-emballement).
+// La correction du PI est bornée à +/- ASSERV_CORRECTION_MAX autour de
+// l'anticipation : un codeur débranché ne peut pas envoyer le moteur à
+// fond, il ajoute au plus ASSERV_CORRECTION_MAX au rapport cyclique.
+//
+// Avec -DBOUCLE_OUVERTE, seule l'anticipation est appliquée.
+//
+// Les paramètres du modèle et les gains sont à identifier sur le robot
+// (vitesse en fronts de codeur par seconde, rapport cyclique de 0 à
+// ASSERV_RC_MAX pour pwm_init(149, 2)).
+///////////////////////////////////////////////////////////////////////////////
+
+// Boucle externe tous les ASSERV_DIVISEUR tics (250 Hz pour un tic de 1 ms)
+#define ASSERV_DIVISEUR     4
+
+// Rapport cyclique maximal : 4 x (period + 1) de pwm_init
+#define ASSERV_RC_MAX       600
+
+// Modèle statique du moteur
+#define MOTEUR_MORT         40      // rapport cyclique de démarrage
+#define MOTEUR_GAIN_Q8      2560    // fronts/s par unité de rc, x 256
+// Modèle dynamique (premier ordre avec retard), identification.h
+#define MOTEUR_TAU_MS       30      // constante de temps
+#define MOTEUR_RETARD_MS    5       // retard pur
+
+// Vitesse obtenue en boucle ouverte avec le rapport cyclique rc : roue
+// arrêtée jusqu'à MOTEUR_MORT (rc évalué deux fois)
+#define MOTEUR_VITESSE(rc)  ((rc) <= MOTEUR_MORT ? 0 : (unsigned int) \
+        (((unsigned long) ((rc) - MOTEUR_MORT) * MOTEUR_GAIN_Q8) >> 8))
+
+// Correcteur PI, Q8 (valeurs par défaut, voir asserv_gains)
+#define ASSERV_KP_Q8        13      // 0,05 rc par front/s d'erreur
+#define ASSERV_KI_Q8        1       // par tic
+#define ASSERV_CORRECTION_MAX   90  // rc, 15 % de la pleine échelle
+
+void asserv_init(void);
+
+// Gains du PI en Q8, hors course (menu de réglage)
+void asserv_gains(unsigned char kp, unsigned char ki);
+
+// Consignes en fronts/s, roue droite (PWM1) et gauche (PWM2)
+void asserv_consigne(unsigned int droite, unsigned int gauche);
+
+// A chaque tic de commande, après codeurs_mesurer()
+void asserv_calculer(void);
+
+// Moteurs arrêtés, consignes et intégrales à zéro
+void asserv_arreter(void);
+
+// Rapport cyclique appliqué à la roue CODEUR_DROIT ou CODEUR_GAUCHE
+unsigned int asserv_rc(unsigned char roue);
+
+#endif
@@ -18,6 +18,19 @@
 //     Broches configures en analogique par adc_init
 //     Temps de conversion : environ 25 us
 //
+//   void adc_scan_init(const char *canaux, unsigned char nb,
+//                      void (*fin)(void));
+//   void adc_scan_etape(unsigned char rang, void (*etape)(void));
+//   char adc_scan_lancer(void);
+//   void adc_scan_it(void);
+//   int adc_scan_valeur(unsigned char rang);
+//     Conversion d'une liste de canaux par interruption : adc_scan_lancer
+//     dmarre la premire conversion, adc_scan_it (routine de l'interruption
+//     ADIF) range le rsultat et enchane la suivante, puis appelle fin
+//     une fois la liste termine. Ne pas utiliser adc_read pendant un scan.
+//     adc_scan_etape fait appeler une routine au milieu du scan, entre la
+//     conversion d'un rang et celle du suivant (commande d'une broche).
+//
 //   Broche - Canal analogique
 //     A0   -   AN0
 //     A1   -   AN1
@@ -123,3 +136,116 @@ int adc_read(char numero_canal) {
     // Renvoi du rsultat de la conversion
     return (((unsigned int) ADRESH) << 8) | ADRESL;
 }
+
+// Scan par interruption
+static const char *adc_scan_canaux;
+static unsigned char adc_scan_nb;
+static void (*adc_scan_fin)(void);
+static unsigned char adc_scan_etape_rang;
+static void (*adc_scan_etape_traitement)(void);
+static volatile unsigned char adc_scan_rang;  // adc_scan_nb : pas de scan
+static int adc_scan_resultats[ADC_SCAN_MAX];
+
+// Slection du canal et dbut de la conversion
+static void adc_scan_convertir(void) {
+    ADCON0 = ((adc_scan_canaux[adc_scan_rang] & 0x07) << 2) | 0x01;
+    ADCON0bits.GO = 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  adc_scan_init
+//  Valeur de retour :  aucune
+//  Paramtres       :  const char *canaux
+//                        numros des canaux  convertir, dans l'ordre
+//                      unsigned char nb
+//                        nombre de canaux (ADC_SCAN_MAX au plus)
+//                      void (*fin)(void)
+//                        routine appele par adc_scan_it  la fin du scan,
+//                        0 si aucune
+//  Description      :  mmorise la liste et autorise l'interruption de
+//                      fin de conversion (ADIE) ; adc_init doit avoir t
+//                      appel et adc_scan_it enregistr (iut_it.h)
+///////////////////////////////////////////////////////////////////////////////
+
+void adc_scan_init(const char *canaux, unsigned char nb, void (*fin)(void)) {
+    if (nb > ADC_SCAN_MAX) nb = ADC_SCAN_MAX;
+    adc_scan_canaux = canaux;
+    adc_scan_nb = nb;
+    adc_scan_fin = fin;
+    adc_scan_rang = nb;
+    adc_scan_etape_traitement = 0;
+
+    PIR1bits.ADIF = 0;
+    PIE1bits.ADIE = 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  adc_scan_etape
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned char rang
+//                        rang de la liste aprs lequel appeler etape
+//                      void (*etape)(void)
+//                        routine appele par adc_scan_it, 0 si aucune
+//  Description      :  la routine est appele aprs la conversion du rang
+//                      et avant le dbut de la suivante,  la mme date
+//                       chaque scan ;  appeler aprs adc_scan_init
+///////////////////////////////////////////////////////////////////////////////
+
+void adc_scan_etape(unsigned char rang, void (*etape)(void)) {
+    adc_scan_etape_rang = rang;
+    adc_scan_etape_traitement = etape;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  adc_scan_lancer
+//  Valeur de retour :  char  =>  1 si le scan est lanc
+//                                0 si le prcdent n'est pas termin
+//  Paramtres       :  aucun
+//  Description      :  slectionne le premier canal et dmarre sa
+//                      conversion ; l'acquisition de 8 TAD est faite
+//                      automatiquement par l'ADC (ADCON2)
+///////////////////////////////////////////////////////////////////////////////
+
+char adc_scan_lancer(void) {
+    if (adc_scan_rang < adc_scan_nb || adc_scan_nb == 0) return 0;
+    adc_scan_rang = 0;
+    adc_scan_convertir();
+    return 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  adc_scan_it
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  routine de l'interruption ADIF : range le rsultat,
+//                      dmarre le canal suivant ou appelle fin
+///////////////////////////////////////////////////////////////////////////////
+
+void adc_scan_it(void) {
+    PIR1bits.ADIF = 0;
+    if (adc_scan_rang >= adc_scan_nb) return; // conversion hors scan
+
+    adc_scan_resultats[adc_scan_rang] = (((unsigned int) ADRESH) << 8) | ADRESL;
+    if (adc_scan_rang == adc_scan_etape_rang && adc_scan_etape_traitement) {
+        adc_scan_etape_traitement();
+    }
+    adc_scan_rang++;
+    if (adc_scan_rang < adc_scan_nb) {
+        adc_scan_convertir();
+    } else if (adc_scan_fin) {
+        adc_scan_fin();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  adc_scan_valeur
+//  Valeur de retour :  int  =>  dernire valeur convertie sur 10 bits
+//  Paramtres       :  unsigned char rang
+//                        rang du canal dans la liste passe  adc_scan_init
+//  Description      :  lecture du rsultat,  faire depuis fin ou sous
+//                      interruptions masques (valeur 16 bits)
+///////////////////////////////////////////////////////////////////////////////
+
+int adc_scan_valeur(unsigned char rang) {
+    return adc_scan_resultats[rang];
+}
@@ -0,0 +1,193 @@
+///////////////////////////////////////////////////////////////////////////////
+// Banc d'essai des fonctions de la bibliothque
+//
+// IUT de Cachan
+// Version 10/2026 pour xc8
+//
+// Voir iut_banc.h pour la description du rapport.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "iut_banc.h"
+#include "iut_adc.h"
+#include "iut_pwm.h"
+#include "iut_lcd.h"
+#include "iut_timers.h"
+#include "iut_uart.h"
+
+// Configuration des chronomtres : horloge interne, prescaler 1:1
+#define BANC_CONFIG_T1  (TIMER_INT_OFF & T1_16BIT_RW & T1_SOURCE_INT \
+        & T1_PS_1_1 & T1_OSC1EN_OFF & T1_SYNC_EXT_OFF)
+#define BANC_CONFIG_T3  (TIMER_INT_OFF & T3_16BIT_RW & T3_SOURCE_INT \
+        & T3_PS_1_1 & T3_SYNC_EXT_OFF & T1_SOURCE_CCP)
+#define BANC_CONFIG_T0  (TIMER_INT_OFF & T0_16BIT & T0_SOURCE_INT & T0_PS_1_1)
+
+// Rsultats rangs ici pour que les appels ne soient pas supprims
+static volatile unsigned int banc_puits;
+
+///////////////////////////////////////////////////////////////////////////////
+// Fonctions mesures, toutes de la forme void f(void)
+///////////////////////////////////////////////////////////////////////////////
+static void banc_vide(void) {
+}
+
+static void banc_adc_read(void) {
+    banc_puits = adc_read(1);
+}
+
+static void banc_pwm_setdc1(void) {
+    pwm_setdc1(0);
+}
+
+static void banc_pwm_setdc2(void) {
+    pwm_setdc2(0);
+}
+
+static void banc_lcd_position(void) {
+    lcd_position(1, 0);
+}
+
+static void banc_lcd_putc(void) {
+    lcd_putc('x');
+}
+
+static void banc_lcd_printf(void) {
+    lcd_printf("%4d", -217);
+}
+
+static void banc_open_timer0(void) {
+    OpenTimer0(BANC_CONFIG_T0);
+}
+
+static void banc_read_timer0(void) {
+    banc_puits = ReadTimer0();
+}
+
+static void banc_open_timer1(void) {
+    OpenTimer1(BANC_CONFIG_T1);
+}
+
+static void banc_read_timer1(void) {
+    banc_puits = ReadTimer1();
+}
+
+static void banc_open_timer3(void) {
+    OpenTimer3(BANC_CONFIG_T3);
+}
+
+static void banc_read_timer3(void) {
+    banc_puits = ReadTimer3();
+}
+
+// Une ligne du rapport : nom, fonction, budget en cycles instruction,
+// et timer utilis comme chronomtre (1 ou 3)
+struct banc_fonction {
+    const char *nom;
+    void (*fonction)(void);
+    unsigned int budget;
+    unsigned char chrono;
+};
+
+static const struct banc_fonction banc_table[] = {
+    {"adc_read", banc_adc_read, 400, 3},
+    {"pwm_setdc1", banc_pwm_setdc1, 60, 3},
+    {"pwm_setdc2", banc_pwm_setdc2, 60, 3},
+    {"lcd_position", banc_lcd_position, 800, 3},
+    {"lcd_putc", banc_lcd_putc, 800, 3},
+    {"lcd_printf_4d", banc_lcd_printf, 10000, 3},
+    {"OpenTimer0", banc_open_timer0, 60, 3},
+    {"ReadTimer0", banc_read_timer0, 40, 3},
+    {"OpenTimer1", banc_open_timer1, 80, 3},
+    {"ReadTimer1", banc_read_timer1, 40, 3},
+    {"OpenTimer3", banc_open_timer3, 100, 1},
+    {"ReadTimer3", banc_read_timer3, 40, 1},
+};
+
+#define BANC_NB_FONCTIONS (sizeof(banc_table) / sizeof(banc_table[0]))
+
+// Dure d'un appel de f en cycles instruction, cot de la mesure compris
+static unsigned int banc_mesurer(void (*f)(void), unsigned char chrono) {
+    unsigned int t0;
+
+    if (chrono == 3) {
+        t0 = ReadTimer3();
+        f();
+        return ReadTimer3() - t0;
+    }
+    t0 = ReadTimer1();
+    f();
+    return ReadTimer1() - t0;
+}
+
+// Cot de la mesure seule : le minimum sur plusieurs appels  vide
+static unsigned int banc_etalonner(unsigned char chrono) {
+    unsigned char i;
+    unsigned int d, vide = 0xFFFF;
+
+    for (i = 0; i < BANC_NB_MESURES; i++) {
+        d = banc_mesurer(banc_vide, chrono);
+        if (d < vide) vide = d;
+    }
+    return vide;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  banc_essai
+//  Valeur de retour :  unsigned char  =>  nombre de fonctions hors budget
+//  Paramtres       :  aucun
+//  Description      :  mesure chaque fonction BANC_NB_MESURES fois et
+//                      envoie le rapport sur la liaison srie
+//                      lcd_init, adc_init, pwm_init et uart_init doivent
+//                      avoir t appels
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned char banc_essai(void) {
+    unsigned char i, k, hors_budget = 0;
+    unsigned int d, vide1, vide3, vide, min, max;
+    unsigned long somme;
+    const struct banc_fonction *b;
+
+    OpenTimer1(BANC_CONFIG_T1);
+    OpenTimer3(BANC_CONFIG_T3);
+    vide1 = banc_etalonner(1);
+    vide3 = banc_etalonner(3);
+
+    uart_puts("# banc Fosc=48000000 Fcy=12000000\r\n");
+    uart_puts("fonction;nombre;min;max;moyenne;budget;etat\r\n");
+
+    for (k = 0; k < BANC_NB_FONCTIONS; k++) {
+        b = &banc_table[k];
+        vide = (b->chrono == 3) ? vide3 : vide1;
+        min = 0xFFFF;
+        max = 0;
+        somme = 0;
+        for (i = 0; i < BANC_NB_MESURES; i++) {
+            d = banc_mesurer(b->fonction, b->chrono);
+            d = (d > vide) ? d - vide : 0;
+            if (d < min) min = d;
+            if (d > max) max = d;
+            somme += d;
+        }
+
+        uart_puts(b->nom);
+        uart_putc(';');
+        uart_putu(BANC_NB_MESURES);
+        uart_putc(';');
+        uart_putu(min);
+        uart_putc(';');
+        uart_putu(max);
+        uart_putc(';');
+        uart_putu(somme / BANC_NB_MESURES);
+        uart_putc(';');
+        uart_putu(b->budget);
+        if (max > b->budget) {
+            uart_puts(";DEPASSE\r\n");
+            hors_budget++;
+        } else {
+            uart_puts(";OK\r\n");
+        }
+    }
+
+    lcd_clear();
+    lcd_printf("banc: %d/%d\nhors budget", hors_budget, (int) BANC_NB_FONCTIONS);
+    return hors_budget;
+}
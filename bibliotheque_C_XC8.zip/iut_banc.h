@@ -0,0 +1,60 @@
+#ifndef __IUT_BANC_H
+#define __IUT_BANC_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Banc d'essai des fonctions de la bibliothque
+//
+// IUT de Cachan
+// Version 10/2026 pour xc8
+//
+// Mesure sur la carte du nombre de cycles instruction consomms par les
+// fonctions les plus utilises dans la boucle principale :
+//   adc_read, pwm_setdc1, pwm_setdc2, lcd_position, lcd_putc,
+//   lcd_printf("%4d"), OpenTimerN et ReadTimerN (N = 0, 1, 3)
+//
+// Chaque fonction est appele BANC_NB_MESURES fois. Chaque appel est
+// chronomtr par le Timer3 (ou le Timer1 pour les fonctions du Timer3),
+// prescaler 1:1, donc au cycle instruction prs (83,3 ns pour Fosc = 48 MHz).
+// Le cot de la mesure elle-mme est mesur  vide puis retranch.
+//
+// Le rapport est envoy sur la liaison srie (uart_init doit avoir t
+// appel), une ligne par fonction, sparateur ';' :
+//   # banc Fosc=48000000 Fcy=12000000
+//   fonction;nombre;min;max;moyenne;budget;etat
+// min, max, moyenne et budget en cycles instruction. La colonne etat
+// vaut OK, ou DEPASSE si le max dpasse le budget : une rgression sur une
+// fonction critique se voit ds le premier essai sur la carte.
+//
+// Les budgets sont des plafonds volontairement larges,  resserrer
+// aprs une premire mesure.
+//
+// Les Timer0, Timer1 et Timer3 sont reconfigurs, le banc doit donc tre
+// lanc avant toute autre utilisation de ces timers. Les moteurs restent
+//  l'arrt (rapport cyclique 0 pendant la mesure des pwm_setdc).
+//
+// Fonctions disponibles
+//
+//   unsigned char banc_essai(void);
+//     Lance toutes les mesures et envoie le rapport.
+//     Renvoie le nombre de fonctions hors budget.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <xc.h>
+
+#ifndef BANC_NB_MESURES
+#define BANC_NB_MESURES 16
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  banc_essai
+//  Valeur de retour :  unsigned char  =>  nombre de fonctions hors budget
+//  Paramtres       :  aucun
+//  Description      :  mesure chaque fonction BANC_NB_MESURES fois et
+//                      envoie le rapport sur la liaison srie
+//                      lcd_init, adc_init, pwm_init et uart_init doivent
+//                      avoir t appels
+///////////////////////////////////////////////////////////////////////////////
+unsigned char banc_essai(void);
+
+#endif
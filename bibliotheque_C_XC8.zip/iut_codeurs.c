@@ -0,0 +1,140 @@
+///////////////////////////////////////////////////////////////////////////////
+// Mesure de la vitesse des roues par codeurs incrmentaux
+//
+// IUT de Cachan
+// Version 10/2026 pour xc8
+//
+// Voir iut_codeurs.h pour la description des fonctions disponibles.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "iut_codeurs.h"
+#include "iut_it.h"
+
+struct codeur {
+    unsigned long nombre;       // fronts compts par l'interruption
+    unsigned long instant;      // date du dernier front
+    unsigned long nombre_prec;  // valeurs au prcdent codeurs_mesurer
+    unsigned long instant_prec;
+    char valide;                // instant_prec date un vrai front
+    unsigned int vitesse;       // fronts par seconde
+};
+
+static struct codeur codeurs[2];
+
+static void codeurs_front(struct codeur *c) {
+    c->instant = temps_lire();
+    c->nombre++;
+}
+
+static void codeurs_it_droit(void) {
+    INTCONbits.INT0IF = 0;
+    codeurs_front(&codeurs[CODEUR_DROIT]);
+}
+
+static void codeurs_it_gauche(void) {
+    INTCON3bits.INT1IF = 0;
+    codeurs_front(&codeurs[CODEUR_GAUCHE]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  codeurs_init
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  RB0 et RB1 en entres, interruptions INT0 et INT1
+//                      sur front montant, enregistres en priorit haute
+///////////////////////////////////////////////////////////////////////////////
+
+void codeurs_init(void) {
+    unsigned char r;
+
+    for (r = 0; r < 2; r++) {
+        codeurs[r].nombre = 0;
+        codeurs[r].nombre_prec = 0;
+        codeurs[r].valide = 0;
+        codeurs[r].vitesse = 0;
+    }
+
+    TRISBbits.TRISB0 = 1;
+    TRISBbits.TRISB1 = 1;
+    INTCON2bits.INTEDG0 = 1;
+    INTCON2bits.INTEDG1 = 1;
+
+    it_enregistrer(IT_INT0, IT_HAUTE, codeurs_it_droit);
+    it_enregistrer(IT_INT1, IT_HAUTE, codeurs_it_gauche);
+    INTCONbits.INT0IF = 0;
+    INTCON3bits.INT1IF = 0;
+    INTCONbits.INT0IE = 1;
+    INTCON3bits.INT1IE = 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  codeurs_mesurer
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  calcule la vitesse de chaque roue depuis l'appel
+//                      prcdent ;  appeler depuis le tic de commande
+//                      (priorit haute, comme les routines des codeurs)
+///////////////////////////////////////////////////////////////////////////////
+
+void codeurs_mesurer(void) {
+    unsigned char r;
+    unsigned int n;
+    unsigned long t, dt, v;
+    struct codeur *c;
+
+    t = temps_lire();
+    for (r = 0; r < 2; r++) {
+        c = &codeurs[r];
+        n = (unsigned int) (c->nombre - c->nombre_prec);
+        if (n) {
+            // mthode M/T : n fronts entre le dernier front du tic
+            // prcdent et le dernier front de ce tic
+            dt = c->instant - c->instant_prec;
+            if (c->valide && dt) {
+                v = n * TEMPS_PAR_S / dt;
+                c->vitesse = (v > 0xFFFF) ? 0xFFFF : (unsigned int) v;
+            }
+            c->nombre_prec = c->nombre;
+            c->instant_prec = c->instant;
+            c->valide = 1;
+        } else if (c->valide) {
+            // pas de front : le suivant ne peut pas arriver avant t
+            dt = t - c->instant_prec;
+            if (dt > CODEURS_ARRET) {
+                c->vitesse = 0;
+                c->valide = 0;
+            } else {
+                v = TEMPS_PAR_S / dt;
+                if (c->vitesse > v) c->vitesse = (unsigned int) v;
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  codeurs_vitesse
+//  Valeur de retour :  unsigned int  =>  fronts par seconde
+//  Paramtres       :  unsigned char roue
+//                        CODEUR_DROIT ou CODEUR_GAUCHE
+//  Description      :  vitesse calcule au dernier codeurs_mesurer
+//                      lecture 16 bits :  appeler en priorit haute ou
+//                      sous interruptions masques
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int codeurs_vitesse(unsigned char roue) {
+    return codeurs[roue].vitesse;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  codeurs_nombre
+//  Valeur de retour :  unsigned long  =>  nombre de fronts
+//  Paramtres       :  unsigned char roue
+//                        CODEUR_DROIT ou CODEUR_GAUCHE
+//  Description      :  fronts compts depuis codeurs_init (distance)
+//                      lecture 32 bits :  appeler en priorit haute ou
+//                      sous interruptions masques
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned long codeurs_nombre(unsigned char roue) {
+    return codeurs[roue].nombre;
+}
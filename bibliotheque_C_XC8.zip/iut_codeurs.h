@@ -0,0 +1,103 @@
+#ifndef __IUT_CODEURS_H
+#define __IUT_CODEURS_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Mesure de la vitesse des roues par codeurs incrmentaux
+//
+// IUT de Cachan
+// Version 10/2026 pour xc8
+//
+// Une voie de codeur par roue, sur les entres d'interruption INT0 et
+// INT1. Les modules CCP servent au PWM des moteurs et le Timer1 et le
+// Timer3 partagent la mme entre d'horloge externe (T13CKI) : ni la
+// capture ni le comptage matriel des deux roues ne sont possibles. Chaque
+// front montant est donc compt et dat par interruption de priorit
+// haute sur la base de temps du Timer1 (iut_temps.h) : c'est une capture
+// logicielle,  0,667 us prs plus la latence d'interruption.
+//
+// codeurs_mesurer(), appele  chaque tic de commande, calcule la vitesse
+// par la mthode M/T : nombre de fronts depuis le tic prcdent divis
+// par l'cart entre le dernier front de ce tic et celui du tic prcdent.
+// A grande vitesse on compte beaucoup de fronts,  petite vitesse on
+// mesure la priode d'un front : la prcision reste bonne dans les deux
+// cas. Sans front pendant un tic, la vitesse est borne par l'inverse du
+// temps coul depuis le dernier front, et vaut 0 aprs CODEURS_ARRET.
+// Cot born : une division 32 bits par roue et par tic au plus.
+//
+// La voie unique ne donne pas le sens de rotation : la vitesse est
+// positive, le sens est celui de la commande des moteurs.
+//
+// Fonctions disponibles
+//
+//   void codeurs_init(void);
+//     Fronts montants sur INT0 et INT1, routines enregistres en priorit
+//     haute (it_init et temps_init doivent avoir t appels)
+//
+//   void codeurs_mesurer(void);
+//     Mise  jour des vitesses,  chaque tic de commande (priorit haute)
+//
+//   unsigned int codeurs_vitesse(unsigned char roue);
+//     Vitesse en fronts par seconde
+//
+//   unsigned long codeurs_nombre(unsigned char roue);
+//     Nombre de fronts depuis codeurs_init
+//
+//   Broche - Signal
+//     B0   -   codeur de la roue droite (INT0)
+//     B1   -   codeur de la roue gauche (INT1)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <xc.h>
+#include "iut_temps.h"
+
+#define CODEUR_DROIT    0
+#define CODEUR_GAUCHE   1
+
+// Dure sans front au-del de laquelle la roue est arrte (100 ms)
+#ifndef CODEURS_ARRET
+#define CODEURS_ARRET   (100 * TEMPS_PAR_MS)
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  codeurs_init
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  RB0 et RB1 en entres, interruptions INT0 et INT1
+//                      sur front montant, enregistres en priorit haute
+///////////////////////////////////////////////////////////////////////////////
+void codeurs_init(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  codeurs_mesurer
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  calcule la vitesse de chaque roue depuis l'appel
+//                      prcdent ;  appeler depuis le tic de commande
+//                      (priorit haute, comme les routines des codeurs)
+///////////////////////////////////////////////////////////////////////////////
+void codeurs_mesurer(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  codeurs_vitesse
+//  Valeur de retour :  unsigned int  =>  fronts par seconde
+//  Paramtres       :  unsigned char roue
+//                        CODEUR_DROIT ou CODEUR_GAUCHE
+//  Description      :  vitesse calcule au dernier codeurs_mesurer
+//                      lecture 16 bits :  appeler en priorit haute ou
+//                      sous interruptions masques
+///////////////////////////////////////////////////////////////////////////////
+unsigned int codeurs_vitesse(unsigned char roue);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  codeurs_nombre
+//  Valeur de retour :  unsigned long  =>  nombre de fronts
+//  Paramtres       :  unsigned char roue
+//                        CODEUR_DROIT ou CODEUR_GAUCHE
+//  Description      :  fronts compts depuis codeurs_init (distance)
+//                      lecture 32 bits :  appeler en priorit haute ou
+//                      sous interruptions masques
+///////////////////////////////////////////////////////////////////////////////
+unsigned long codeurs_nombre(unsigned char roue);
+
+#endif
@@ -0,0 +1,89 @@
+///////////////////////////////////////////////////////////////////////////////
+// Mmoire EEPROM de donnes (256 octets)
+//
+// IUT de Cachan
+// Version 10/2026 pour xc8
+//
+// Voir iut_eeprom.h pour la description des fonctions disponibles.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "iut_eeprom.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  eeprom_lire
+//  Valeur de retour :  unsigned char  =>  octet lu
+//  Paramtres       :  unsigned char adresse
+//  Description      :  attend la fin d'une criture en cours puis lit
+//                      l'octet  l'adresse demande
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned char eeprom_lire(unsigned char adresse) {
+    while (EECON1bits.WR);
+    EEADR = adresse;
+    EECON1bits.EEPGD = 0; // mmoire de donnes
+    EECON1bits.CFGS = 0;
+    EECON1bits.RD = 1;
+    return EEDATA;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  eeprom_ecrire
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned char adresse
+//                      unsigned char octet
+//  Description      :  attend la fin de l'criture prcdente et lance
+//                      l'criture si l'octet est diffrent de celui en
+//                      mmoire ; rend la main sans attendre sa fin
+///////////////////////////////////////////////////////////////////////////////
+
+void eeprom_ecrire(unsigned char adresse, unsigned char octet) {
+    unsigned char gieh, giel;
+
+    if (eeprom_lire(adresse) == octet) return;
+
+    EEDATA = octet; // EEADR, EEPGD et CFGS fixs par eeprom_lire
+    EECON1bits.WREN = 1;
+
+    // Squence de dverrouillage, sans interruption
+    gieh = INTCONbits.GIEH;
+    giel = INTCONbits.GIEL;
+    INTCONbits.GIEH = 0;
+    INTCONbits.GIEL = 0;
+    EECON2 = 0x55;
+    EECON2 = 0xAA;
+    EECON1bits.WR = 1;
+    INTCONbits.GIEL = giel;
+    INTCONbits.GIEH = gieh;
+
+    EECON1bits.WREN = 0; // l'criture lance se poursuit
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  eeprom_occupee
+//  Valeur de retour :  char  =>  1 si une criture est en cours, 0 sinon
+//  Paramtres       :  aucun
+//  Description      :  lecture du bit WR de EECON1
+///////////////////////////////////////////////////////////////////////////////
+
+char eeprom_occupee(void) {
+    return EECON1bits.WR;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  eeprom_crc8
+//  Valeur de retour :  unsigned char  =>  CRC mis  jour
+//  Paramtres       :  unsigned char crc
+//                        CRC des octets prcdents, 0 pour le premier
+//                      unsigned char octet
+//  Description      :  ajoute un octet au CRC-8 de polynme 0x07
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned char eeprom_crc8(unsigned char crc, unsigned char octet) {
+    unsigned char i;
+
+    crc ^= octet;
+    for (i = 0; i < 8; i++) {
+        crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+    return crc;
+}
@@ -0,0 +1,78 @@
+#ifndef __IUT_EEPROM_H
+#define __IUT_EEPROM_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Mmoire EEPROM de donnes (256 octets)
+//
+// IUT de Cachan
+// Version 10/2026 pour xc8
+//
+// Une criture dure environ 4 ms, pendant lesquelles le programme
+// continue : eeprom_ecrire attend seulement la fin de l'criture
+// prcdente. Un octet qui ne change pas n'est pas rcrit (l'EEPROM
+// supporte environ 1 000 000 d'critures par octet).
+//
+// Fonctions disponibles
+//
+//   unsigned char eeprom_lire(unsigned char adresse);
+//     Lecture d'un octet
+//
+//   void eeprom_ecrire(unsigned char adresse, unsigned char octet);
+//     Ecriture d'un octet, les interruptions sont masques pendant la
+//     squence de dverrouillage (5 cycles)
+//
+//   char eeprom_occupee(void);
+//     1 tant qu'une criture est en cours,  utiliser avec
+//     PT_ATTENDRE_QUE (iut_taches.h) pour ne pas attendre dans
+//     eeprom_ecrire
+//
+//   unsigned char eeprom_crc8(unsigned char crc, unsigned char octet);
+//     CRC-8 (polynme 0x07) d'un bloc, octet par octet en partant de 0,
+//     pour reconnatre un bloc mal crit (coupure pendant l'criture)
+//
+// Pour plus d'informations, consultez p18f4550_39632e.pdf 7
+///////////////////////////////////////////////////////////////////////////////
+
+#include <xc.h>
+
+#define EEPROM_TAILLE   256
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  eeprom_lire
+//  Valeur de retour :  unsigned char  =>  octet lu
+//  Paramtres       :  unsigned char adresse
+//  Description      :  attend la fin d'une criture en cours puis lit
+//                      l'octet  l'adresse demande
+///////////////////////////////////////////////////////////////////////////////
+unsigned char eeprom_lire(unsigned char adresse);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  eeprom_ecrire
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned char adresse
+//                      unsigned char octet
+//  Description      :  attend la fin de l'criture prcdente et lance
+//                      l'criture si l'octet est diffrent de celui en
+//                      mmoire ; rend la main sans attendre sa fin
+///////////////////////////////////////////////////////////////////////////////
+void eeprom_ecrire(unsigned char adresse, unsigned char octet);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  eeprom_occupee
+//  Valeur de retour :  char  =>  1 si une criture est en cours, 0 sinon
+//  Paramtres       :  aucun
+//  Description      :  lecture du bit WR de EECON1
+///////////////////////////////////////////////////////////////////////////////
+char eeprom_occupee(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  eeprom_crc8
+//  Valeur de retour :  unsigned char  =>  CRC mis  jour
+//  Paramtres       :  unsigned char crc
+//                        CRC des octets prcdents, 0 pour le premier
+//                      unsigned char octet
+//  Description      :  ajoute un octet au CRC-8 de polynme 0x07
+///////////////////////////////////////////////////////////////////////////////
+unsigned char eeprom_crc8(unsigned char crc, unsigned char octet);
+
+#endif
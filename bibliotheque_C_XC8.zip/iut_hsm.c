@@ -0,0 +1,223 @@
+///////////////////////////////////////////////////////////////////////////////
+// Machines  tats hirarchiques dcrites par tables
+//
+// IUT de Cachan
+// Version 10/2026 pour xc8
+//
+// Voir iut_hsm.h pour la description des fonctions disponibles.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "iut_hsm.h"
+
+#ifdef HSM_TRACE
+#include "iut_temps.h"
+#include "iut_uart.h"
+
+struct hsm_trace {
+    unsigned long date;
+    const struct hsm *machine;
+    unsigned char source;
+    unsigned char evenement;
+    unsigned char cible;
+};
+
+static struct hsm_trace hsm_traces[HSM_TRACE_NB];
+static unsigned char hsm_trace_suivante;   // prochaine entre crite
+static unsigned char hsm_trace_nb;         // entres valides
+
+// Note une transition ; appele depuis le programme principal comme
+// depuis les interruptions : la routine haute est masque pendant
+// l'criture (GIEH vaut dj 0 dans la routine haute)
+static void hsm_noter(const struct hsm *m, unsigned char source,
+        unsigned char evenement, unsigned char cible) {
+    struct hsm_trace *t;
+    unsigned char gieh = INTCONbits.GIEH;
+
+    INTCONbits.GIEH = 0;
+    t = &hsm_traces[hsm_trace_suivante];
+    t->date = temps_lire();
+    t->machine = m;
+    t->source = source;
+    t->evenement = evenement;
+    t->cible = cible;
+    if (++hsm_trace_suivante == HSM_TRACE_NB) hsm_trace_suivante = 0;
+    if (hsm_trace_nb < HSM_TRACE_NB) hsm_trace_nb++;
+    INTCONbits.GIEH = gieh;
+}
+#define HSM_NOTER(m, s, e, c)   hsm_noter(m, s, e, c)
+#else
+#define HSM_NOTER(m, s, e, c)
+#endif
+
+// Vrai si a est l'tat b ou l'un de ses anctres
+static char hsm_contient(const struct hsm *m, unsigned char a, unsigned char b) {
+    while (b != HSM_AUCUN) {
+        if (a == b) return 1;
+        b = m->etats[b].parent;
+    }
+    return 0;
+}
+
+// Entres depuis l'tat depuis (exclu) jusqu' cible (inclus)
+static void hsm_entrer(const struct hsm *m, unsigned char depuis,
+        unsigned char cible) {
+    unsigned char chemin[HSM_PROFONDEUR];
+    unsigned char n = 0;
+    void (*entree)(void);
+
+    while (cible != depuis && n < HSM_PROFONDEUR) {
+        chemin[n++] = cible;
+        cible = m->etats[cible].parent;
+    }
+    while (n) {
+        entree = m->etats[chemin[--n]].entree;
+        if (entree) entree();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  hsm_init
+//  Valeur de retour :  aucune
+//  Paramtres       :  struct hsm *m
+//                      unsigned char initial
+//                        tat initial, sans fils
+//  Description      :  appelle les entres des anctres de l'tat initial
+//                      puis la sienne, et en fait l'tat courant
+///////////////////////////////////////////////////////////////////////////////
+
+void hsm_init(struct hsm *m, unsigned char initial) {
+    hsm_entrer(m, HSM_AUCUN, initial);
+    m->courant = initial;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  hsm_traiter
+//  Valeur de retour :  char  =>  1 si une transition a eu lieu, 0 sinon
+//  Paramtres       :  struct hsm *m
+//                      unsigned char evenement
+//                        de 0  nb_evenements - 1
+//  Description      :  cherche la transition de l'tat courant, puis de
+//                      ses parents, et l'excute
+///////////////////////////////////////////////////////////////////////////////
+
+char hsm_traiter(struct hsm *m, unsigned char evenement) {
+    unsigned char source = m->courant;
+    unsigned char e = source, cible;
+    const struct hsm_transition *t;
+    void (*sortie)(void);
+
+    if (evenement >= m->nb_evenements) return 0;
+
+    // Etat courant puis ses parents
+    do {
+        t = &m->transitions[e * m->nb_evenements + evenement];
+        if (t->cible != HSM_AUCUN) break;
+        e = m->etats[e].parent;
+    } while (e != HSM_AUCUN);
+    if (e == HSM_AUCUN) return 0;
+
+    cible = t->cible;
+    if (cible == HSM_INTERNE) {
+        if (t->action) t->action();
+        HSM_NOTER(m, source, evenement, source);
+        return 1;
+    }
+
+    // Sorties jusqu'au premier anctre strict de la cible (une transition
+    // vers soi-mme ou vers un anctre sort aussi de la cible)
+    e = source;
+    while (e != HSM_AUCUN && (e == cible || !hsm_contient(m, e, cible))) {
+        sortie = m->etats[e].sortie;
+        if (sortie) sortie();
+        e = m->etats[e].parent;
+    }
+    if (t->action) t->action();
+    hsm_entrer(m, e, cible);
+    m->courant = cible;
+    HSM_NOTER(m, source, evenement, cible);
+    return 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  hsm_etat
+//  Valeur de retour :  unsigned char  =>  tat courant
+//  Paramtres       :  const struct hsm *m
+//  Description      :  lecture de l'tat courant
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned char hsm_etat(const struct hsm *m) {
+    return m->courant;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  hsm_activite
+//  Valeur de retour :  aucune
+//  Paramtres       :  const struct hsm *m
+//  Description      :  appelle l'activit de l'tat courant ou, s'il n'en
+//                      a pas, celle de son plus proche parent
+///////////////////////////////////////////////////////////////////////////////
+
+void hsm_activite(const struct hsm *m) {
+    unsigned char e = m->courant;
+
+    while (e != HSM_AUCUN) {
+        if (m->etats[e].activite) {
+            m->etats[e].activite();
+            return;
+        }
+        e = m->etats[e].parent;
+    }
+}
+
+#ifdef HSM_TRACE
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  hsm_trace_effacer
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  vide la trace des transitions
+///////////////////////////////////////////////////////////////////////////////
+
+void hsm_trace_effacer(void) {
+    unsigned char gieh = INTCONbits.GIEH;
+
+    INTCONbits.GIEH = 0;
+    hsm_trace_suivante = 0;
+    hsm_trace_nb = 0;
+    INTCONbits.GIEH = gieh;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  hsm_trace_envoyer
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  envoie sur la liaison srie les transitions notes,
+//                      de la plus ancienne  la plus rcente :
+//                        trace;date;machine;source;evenement;cible
+//                      uart_init doit avoir t appel
+///////////////////////////////////////////////////////////////////////////////
+
+void hsm_trace_envoyer(void) {
+    unsigned char i, n;
+    const struct hsm_trace *t;
+
+    // La plus ancienne suit la plus rcente quand le tampon est plein
+    i = (hsm_trace_nb < HSM_TRACE_NB) ? 0 : hsm_trace_suivante;
+    for (n = 0; n < hsm_trace_nb; n++) {
+        t = &hsm_traces[i];
+        uart_puts("trace;");
+        uart_putu(t->date);
+        uart_putc(';');
+        uart_puts(t->machine->nom);
+        uart_putc(';');
+        uart_puts(t->machine->etats[t->source].nom);
+        uart_putc(';');
+        uart_putu(t->evenement);
+        uart_putc(';');
+        uart_puts(t->machine->etats[t->cible].nom);
+        uart_puts("\r\n");
+        if (++i == HSM_TRACE_NB) i = 0;
+    }
+}
+
+#endif
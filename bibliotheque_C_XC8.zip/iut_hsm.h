@@ -0,0 +1,174 @@
+#ifndef __IUT_HSM_H
+#define __IUT_HSM_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Machines  tats hirarchiques dcrites par tables
+//
+// IUT de Cachan
+// Version 10/2026 pour xc8
+//
+// Une machine est dcrite par deux tables constantes (en mmoire
+// programme) :
+//   - les tats, numrots de 0  nb - 1 : nom, tat parent (HSM_AUCUN
+//     pour un tat de premier niveau), actions d'entre, de sortie et
+//     activit (appele par hsm_activite tant que l'tat est actif) ;
+//   - les transitions, une ligne par tat et une colonne par vnement :
+//     tat cible et action de la transition.
+// Une case sans transition (cible HSM_AUCUN) renvoie au parent de l'tat :
+// ce que le parent traite vaut pour tous ses fils. La cible HSM_INTERNE
+// excute l'action sans changer d'tat.
+//
+// Traitement d'un vnement : une lecture de table par niveau de
+// hirarchie (HSM_PROFONDEUR niveaux au plus), quel que soit le nombre
+// d'tats et d'vnements. Une transition appelle les sorties de l'tat
+// courant jusqu' l'anctre commun avec la cible, l'action, puis les
+// entres jusqu' la cible, qui doit tre un tat sans fils.
+//
+// L'tat courant ne change qu' la fin de la transition : une machine
+// traite depuis deux niveaux d'interruption reste cohrente si chaque
+// tat ne reoit ses vnements que d'un seul niveau.
+//
+// Avec -DHSM_TRACE, chaque transition est date (iut_temps.h) et note
+// dans un tampon circulaire de HSM_TRACE_NB entres, envoy aprs coup
+// sur la liaison srie. Sans HSM_TRACE, la trace ne cote rien.
+//
+// Fonctions disponibles
+//
+//   void hsm_init(struct hsm *m, unsigned char initial);
+//     Entre dans l'tat initial (entres depuis le premier niveau)
+//
+//   char hsm_traiter(struct hsm *m, unsigned char evenement);
+//     Traite un vnement, renvoie 1 s'il a dclench une transition
+//
+//   unsigned char hsm_etat(const struct hsm *m);
+//     Etat courant
+//
+//   void hsm_activite(const struct hsm *m);
+//     Appelle l'activit de l'tat courant (ou de son plus proche parent
+//     qui en a une)
+//
+//   void hsm_trace_effacer(void);
+//   void hsm_trace_envoyer(void);
+//     Trace des transitions (avec -DHSM_TRACE seulement), une ligne par
+//     transition, de la plus ancienne  la plus rcente, date en pas de
+//     0,667 us :
+//       trace;date;machine;source;evenement;cible
+//
+// Exemple
+//
+//   enum {ARRET, MARCHE};                   // tats
+//   enum {EVT_BOUTON, NB_EVT};              // vnements
+//
+//   const struct hsm_etat etats[] = {
+//       {"arret", HSM_AUCUN, 0, 0, 0},
+//       {"marche", HSM_AUCUN, allumer, eteindre, 0},
+//   };
+//   const struct hsm_transition transitions[][NB_EVT] = {
+//       {{MARCHE, 0}},                      // ARRET
+//       {{ARRET, 0}},                       // MARCHE
+//   };
+//   struct hsm machine = {"moteur", etats, transitions[0], NB_EVT};
+//
+//   hsm_init(&machine, ARRET);
+//   hsm_traiter(&machine, EVT_BOUTON);     // entre dans MARCHE : allumer()
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <xc.h>
+
+// Pas d'tat : parent d'un tat de premier niveau, case sans transition
+#define HSM_AUCUN       0xFF
+// Transition interne : action seule, pas de sortie ni d'entre
+#define HSM_INTERNE     0xFE
+
+// Nombre maximal de niveaux d'tats imbriqus
+#define HSM_PROFONDEUR  4
+
+#ifndef HSM_TRACE_NB
+#define HSM_TRACE_NB    16
+#endif
+
+struct hsm_etat {
+    const char *nom;
+    unsigned char parent;
+    void (*entree)(void);
+    void (*sortie)(void);
+    void (*activite)(void);
+};
+
+struct hsm_transition {
+    unsigned char cible;
+    void (*action)(void);
+};
+
+struct hsm {
+    const char *nom;
+    const struct hsm_etat *etats;
+    const struct hsm_transition *transitions;   // nb tats x nb_evenements
+    unsigned char nb_evenements;
+    volatile unsigned char courant;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  hsm_init
+//  Valeur de retour :  aucune
+//  Paramtres       :  struct hsm *m
+//                      unsigned char initial
+//                        tat initial, sans fils
+//  Description      :  appelle les entres des anctres de l'tat initial
+//                      puis la sienne, et en fait l'tat courant
+///////////////////////////////////////////////////////////////////////////////
+void hsm_init(struct hsm *m, unsigned char initial);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  hsm_traiter
+//  Valeur de retour :  char  =>  1 si une transition a eu lieu, 0 sinon
+//  Paramtres       :  struct hsm *m
+//                      unsigned char evenement
+//                        de 0  nb_evenements - 1
+//  Description      :  cherche la transition de l'tat courant, puis de
+//                      ses parents, et l'excute
+///////////////////////////////////////////////////////////////////////////////
+char hsm_traiter(struct hsm *m, unsigned char evenement);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  hsm_etat
+//  Valeur de retour :  unsigned char  =>  tat courant
+//  Paramtres       :  const struct hsm *m
+//  Description      :  lecture de l'tat courant
+///////////////////////////////////////////////////////////////////////////////
+unsigned char hsm_etat(const struct hsm *m);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  hsm_activite
+//  Valeur de retour :  aucune
+//  Paramtres       :  const struct hsm *m
+//  Description      :  appelle l'activit de l'tat courant ou, s'il n'en
+//                      a pas, celle de son plus proche parent
+///////////////////////////////////////////////////////////////////////////////
+void hsm_activite(const struct hsm *m);
+
+#ifdef HSM_TRACE
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  hsm_trace_effacer
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  vide la trace des transitions
+///////////////////////////////////////////////////////////////////////////////
+void hsm_trace_effacer(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  hsm_trace_envoyer
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  envoie sur la liaison srie les transitions notes,
+//                      de la plus ancienne  la plus rcente :
+//                        trace;date;machine;source;evenement;cible
+//                      uart_init doit avoir t appel
+///////////////////////////////////////////////////////////////////////////////
+void hsm_trace_envoyer(void);
+
+#endif
+
+#endif
@@ -24,8 +24,11 @@
 #pragma config FOSC = ECPLLIO_EC
 // Rgulateur de tension USB activ
 #pragma config VREGEN = ON
-// Watchdog Timer dsactiv
+// Watchdog Timer dsactiv au dmarrage, activ par logiciel (SWDTEN)
+// une fois l'initialisation termine
 #pragma config WDT = OFF
+// Postscaler du Watchdog 1:128 => environ 0,5s (4ms x 128)
+#pragma config WDTPS = 128
 // PortB<4:0> E/S TOR aprs RESET
 #pragma config PBADEN = OFF
 // Low Voltage ICSP dsactiv
@@ -0,0 +1,250 @@
+///////////////////////////////////////////////////////////////////////////////
+// Gestion des interruptions  deux niveaux de priorit
+//
+// IUT de Cachan
+// Version 10/2026 pour xc8
+//
+// Voir iut_it.h pour la description des fonctions disponibles.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "iut_it.h"
+#include "iut_timers.h"
+
+// Cycles perdus entre la lecture et l'criture du Timer0 dans it_tic
+// (copies, addition 16 bits, 2 cycles d'inhibition aprs l'criture)
+// estims sur le code gnr,  vrifier  l'oscilloscope
+#define IT_TIC_CORRECTION   12
+
+// Registres et bits d'une source : drapeau (xxIF), autorisation (xxIE),
+// priorit (xxIP, absent pour INT0)
+struct it_source {
+    volatile unsigned char *drapeau;
+    unsigned char masque_if;
+    volatile unsigned char *autorisation;
+    unsigned char masque_ie;
+    volatile unsigned char *priorite;
+    unsigned char masque_ip;
+};
+
+// Dans l'ordre des numros IT_xxx
+static const struct it_source it_sources[IT_NB_SOURCES] = {
+    {&INTCON, 0x02, &INTCON, 0x10, 0, 0}, // IT_INT0
+    {&INTCON3, 0x01, &INTCON3, 0x08, &INTCON3, 0x40}, // IT_INT1
+    {&INTCON3, 0x02, &INTCON3, 0x10, &INTCON3, 0x80}, // IT_INT2
+    {&INTCON, 0x04, &INTCON, 0x20, &INTCON2, 0x04}, // IT_TMR0
+    {&INTCON, 0x01, &INTCON, 0x08, &INTCON2, 0x01}, // IT_RB
+    {&PIR1, 0x40, &PIE1, 0x40, &IPR1, 0x40}, // IT_AD
+    {&PIR1, 0x20, &PIE1, 0x20, &IPR1, 0x20}, // IT_RC
+    {&PIR1, 0x10, &PIE1, 0x10, &IPR1, 0x10}, // IT_TX
+    {&PIR1, 0x04, &PIE1, 0x04, &IPR1, 0x04}, // IT_CCP1
+    {&PIR1, 0x02, &PIE1, 0x02, &IPR1, 0x02}, // IT_TMR2
+    {&PIR1, 0x01, &PIE1, 0x01, &IPR1, 0x01}, // IT_TMR1
+    {&PIR2, 0x01, &PIE2, 0x01, &IPR2, 0x01}, // IT_CCP2
+    {&PIR2, 0x02, &PIE2, 0x02, &IPR2, 0x02}, // IT_TMR3
+    {&PIR2, 0x20, &PIE2, 0x20, &IPR2, 0x20}, // IT_USB
+};
+
+static void (*it_traitements[IT_NB_SOURCES])(void);
+
+// Sources enregistres, par niveau, dans l'ordre d'enregistrement
+static unsigned char it_hautes[IT_NB_SOURCES];
+static unsigned char it_nb_hautes;
+static unsigned char it_basses[IT_NB_SOURCES];
+static unsigned char it_nb_basses;
+
+// Tic de commande
+static void (*it_tic_traitement)(void);
+static unsigned int it_recharge;
+static union Timers it_entree;
+static unsigned char it_entree_tic;    // TMR0IF dj  1  l'entre
+static volatile unsigned int it_latence;
+
+// Appelle les routines des sources de la liste dont le drapeau et
+// l'autorisation sont  1
+static void it_parcourir(const unsigned char *liste, unsigned char nb) {
+    unsigned char i, n;
+    const struct it_source *s;
+
+    for (i = 0; i < nb; i++) {
+        n = liste[i];
+        s = &it_sources[n];
+        if ((*s->drapeau & s->masque_if) && (*s->autorisation & s->masque_ie)) {
+            it_traitements[n]();
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Routines d'interruption
+///////////////////////////////////////////////////////////////////////////////
+
+void interrupt high_priority it_haute(void) {
+    // Lecture du Timer0 avant tout traitement : latence du tic. Le
+    // drapeau d'abord : s'il est  1, la valeur lue suit le dbordement
+    it_entree_tic = INTCONbits.TMR0IF;
+    it_entree.bt[0] = TMR0L;
+    it_entree.bt[1] = TMR0H;
+
+    it_parcourir(it_hautes, it_nb_hautes);
+}
+
+void interrupt low_priority it_basse(void) {
+    it_parcourir(it_basses, it_nb_basses);
+}
+
+// Dbordement du Timer0 : rechargement relatif  la valeur courante, le
+// tic suivant arrive une priode aprs ce dbordement quelle que soit la
+// latence
+static void it_tic(void) {
+    union Timers t;
+    unsigned int lu;
+
+    INTCONbits.TMR0IF = 0;
+
+    t.bt[0] = TMR0L;
+    t.bt[1] = TMR0H;
+    lu = t.lt;
+    t.lt += it_recharge;
+    TMR0H = t.bt[1];
+    TMR0L = t.bt[0];
+
+    // Entre due  une autre source (codeurs, ADC), dbordement pendant
+    // son traitement : la valeur d'entre prcde le dbordement, la
+    // latence est celle du tic lui-mme
+    if (!it_entree_tic) it_entree.lt = lu;
+    if (it_entree.lt > it_latence) it_latence = it_entree.lt;
+
+    it_tic_traitement();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  it_init
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  passe en mode priorit (IPEN = 1), met toutes les
+//                      sources en priorit basse et interdit les
+//                      interruptions jusqu' l'appel de it_autoriser
+///////////////////////////////////////////////////////////////////////////////
+
+void it_init(void) {
+    unsigned char n;
+
+    INTCONbits.GIEH = 0;
+    INTCONbits.GIEL = 0;
+    RCONbits.IPEN = 1;
+
+    // Au reset, toutes les sources sont en priorit haute
+    INTCON2 &= ~0x05; // TMR0IP = RBIP = 0
+    INTCON3 &= ~0xC0; // INT2IP = INT1IP = 0
+    IPR1 = 0;
+    IPR2 = 0;
+
+    for (n = 0; n < IT_NB_SOURCES; n++) {
+        it_traitements[n] = 0;
+    }
+    it_nb_hautes = 0;
+    it_nb_basses = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  it_enregistrer
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned char source
+//                        IT_INT0, IT_TMR0, IT_AD...
+//                      unsigned char priorite
+//                        IT_HAUTE ou IT_BASSE
+//                      void (*traitement)(void)
+//                        routine appele par le vecteur correspondant
+//  Description      :  fixe le bit de priorit de la source et l'ajoute 
+//                      la liste parcourue par le vecteur de ce niveau
+//                       appeler avant it_autoriser
+///////////////////////////////////////////////////////////////////////////////
+
+void it_enregistrer(unsigned char source, unsigned char priorite,
+        void (*traitement)(void)) {
+    const struct it_source *s;
+
+    // Source inconnue ou dj enregistre
+    if (source >= IT_NB_SOURCES || it_traitements[source]) return;
+
+    s = &it_sources[source];
+    it_traitements[source] = traitement;
+
+    // INT0 n'a pas de bit de priorit : toujours haute
+    if (s->priorite == 0) priorite = IT_HAUTE;
+
+    if (priorite == IT_HAUTE) {
+        if (s->priorite) *s->priorite |= s->masque_ip;
+        it_hautes[it_nb_hautes++] = source;
+    } else {
+        *s->priorite &= ~s->masque_ip;
+        it_basses[it_nb_basses++] = source;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  it_autoriser
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  autorise les interruptions hautes et basses
+///////////////////////////////////////////////////////////////////////////////
+
+void it_autoriser(void) {
+    INTCONbits.GIEL = 1;
+    INTCONbits.GIEH = 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  it_tic_init
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned int periode
+//                        priode du tic en cycles instruction
+//                      void (*traitement)(void)
+//                        routine appele  chaque tic, en priorit haute
+//  Description      :  dmarre le Timer0 (16 bits, prescaler 1:1) et
+//                      l'enregistre en priorit haute ; le Timer0 est
+//                      recharg  chaque tic sans cumuler la latence
+///////////////////////////////////////////////////////////////////////////////
+
+void it_tic_init(unsigned int periode, void (*traitement)(void)) {
+    it_tic_traitement = traitement;
+    it_recharge = (unsigned int) (0 - periode) + IT_TIC_CORRECTION;
+    it_latence = 0;
+
+    it_enregistrer(IT_TMR0, IT_HAUTE, it_tic);
+    OpenTimer0(TIMER_INT_ON & T0_16BIT & T0_SOURCE_INT & T0_PS_1_1);
+    WriteTimer0(0 - periode);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  it_latence_max
+//  Valeur de retour :  unsigned int  =>  latence maximale en cycles
+//  Paramtres       :  aucun
+//  Description      :  plus grand dlai mesur entre le dbordement du
+//                      Timer0 et l'entre dans la routine haute
+//                       appeler hors interruption, aprs it_autoriser
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int it_latence_max(void) {
+    unsigned int l;
+
+    // Lecture 16 bits non atomique : la routine haute est masque
+    INTCONbits.GIEH = 0;
+    l = it_latence;
+    INTCONbits.GIEH = 1;
+    return l;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  it_latence_effacer
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  remet  zro la latence maximale
+//                       appeler hors interruption, aprs it_autoriser
+///////////////////////////////////////////////////////////////////////////////
+
+void it_latence_effacer(void) {
+    INTCONbits.GIEH = 0;
+    it_latence = 0;
+    INTCONbits.GIEH = 1;
+}
@@ -0,0 +1,144 @@
+#ifndef __IUT_IT_H
+#define __IUT_IT_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Gestion des interruptions  deux niveaux de priorit
+//
+// IUT de Cachan
+// Version 10/2026 pour xc8
+//
+// Les interruptions sont utilises en mode priorit (IPEN = 1) :
+//   - priorit haute (vecteur 0x08) : tic de commande, fin de conversion
+//     ADC, codeurs... tout ce qui fixe la prcision de la commande, et la
+//     base de temps qu'ils lisent
+//   - priorit basse (vecteur 0x18) : entres, liaison srie... tout ce
+//     qui peut attendre quelques dizaines de us
+//
+// Chaque bibliothque enregistre sa routine de traitement pour une source.
+// La routine est appele quand le drapeau ET l'autorisation de la source
+// sont  1. Elle doit remettre le drapeau  0. L'autorisation (bit xxIE)
+// reste  la charge de la bibliothque (OpenTimerN, adc_scan_init...).
+// Chaque vecteur ne parcourt que les sources enregistres  son niveau,
+// dans l'ordre d'enregistrement : enregistrer d'abord la plus urgente.
+//
+// Le tic de commande utilise le Timer0 en 16 bits, prescaler 1:1. A
+// l'entre dans la routine haute, le Timer0 vaut le nombre de cycles
+// couls depuis son dbordement : c'est la latence de l'interruption
+// (sauvegarde du contexte comprise), dont le maximum est conserv. Si la
+// routine haute a t appele pour une autre source et que le Timer0 a
+// dbord pendant ce traitement, la latence est lue au traitement du tic.
+//
+// Fonctions disponibles
+//
+//   void it_init(void);
+//     Mode priorit, toutes les sources en priorit basse, aucune
+//     routine enregistre, interruptions interdites
+//
+//   void it_enregistrer(unsigned char source, unsigned char priorite,
+//                       void (*traitement)(void));
+//     Associe une routine et une priorit  une source
+//
+//   void it_autoriser(void);
+//     Autorise les interruptions des deux niveaux (GIEH = GIEL = 1)
+//
+//   void it_tic_init(unsigned int periode, void (*traitement)(void));
+//     Tic priodique de priorit haute, priode en cycles instruction
+//       it_tic_init(12000, commande); // 1 kHz pour Fosc = 48 MHz
+//
+//   unsigned int it_latence_max(void);
+//   void it_latence_effacer(void);
+//     Latence maximale du tic, en cycles instruction (83,3 ns)
+//
+// Pour plus d'informations, consultez p18f4550_39632e.pdf 9
+///////////////////////////////////////////////////////////////////////////////
+
+#include <xc.h>
+
+// Sources d'interruption
+#define IT_INT0     0   // RB0, toujours en priorit haute
+#define IT_INT1     1   // RB1
+#define IT_INT2     2   // RB2
+#define IT_TMR0     3
+#define IT_RB       4   // changement d'tat RB4  RB7
+#define IT_AD       5   // fin de conversion ADC
+#define IT_RC       6   // rception EUSART
+#define IT_TX       7   // mission EUSART
+#define IT_CCP1     8
+#define IT_TMR2     9
+#define IT_TMR1     10
+#define IT_CCP2     11
+#define IT_TMR3     12
+#define IT_USB      13
+#define IT_NB_SOURCES 14
+
+// Priorits
+#define IT_BASSE    0
+#define IT_HAUTE    1
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  it_init
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  passe en mode priorit (IPEN = 1), met toutes les
+//                      sources en priorit basse et interdit les
+//                      interruptions jusqu' l'appel de it_autoriser
+///////////////////////////////////////////////////////////////////////////////
+void it_init(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  it_enregistrer
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned char source
+//                        IT_INT0, IT_TMR0, IT_AD...
+//                      unsigned char priorite
+//                        IT_HAUTE ou IT_BASSE
+//                      void (*traitement)(void)
+//                        routine appele par le vecteur correspondant
+//  Description      :  fixe le bit de priorit de la source et l'ajoute 
+//                      la liste parcourue par le vecteur de ce niveau
+//                       appeler avant it_autoriser
+///////////////////////////////////////////////////////////////////////////////
+void it_enregistrer(unsigned char source, unsigned char priorite,
+        void (*traitement)(void));
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  it_autoriser
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  autorise les interruptions hautes et basses
+///////////////////////////////////////////////////////////////////////////////
+void it_autoriser(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  it_tic_init
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned int periode
+//                        priode du tic en cycles instruction
+//                      void (*traitement)(void)
+//                        routine appele  chaque tic, en priorit haute
+//  Description      :  dmarre le Timer0 (16 bits, prescaler 1:1) et
+//                      l'enregistre en priorit haute ; le Timer0 est
+//                      recharg  chaque tic sans cumuler la latence
+///////////////////////////////////////////////////////////////////////////////
+void it_tic_init(unsigned int periode, void (*traitement)(void));
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  it_latence_max
+//  Valeur de retour :  unsigned int  =>  latence maximale en cycles
+//  Paramtres       :  aucun
+//  Description      :  plus grand dlai mesur entre le dbordement du
+//                      Timer0 et l'entre dans la routine haute
+//                       appeler hors interruption, aprs it_autoriser
+///////////////////////////////////////////////////////////////////////////////
+unsigned int it_latence_max(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  it_latence_effacer
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  remet  zro la latence maximale
+//                       appeler hors interruption, aprs it_autoriser
+///////////////////////////////////////////////////////////////////////////////
+void it_latence_effacer(void);
+
+#endif
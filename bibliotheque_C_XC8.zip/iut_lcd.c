@@ -46,6 +46,22 @@
 //     D3   -    non connecte
 //   D4-D7  -    Data[4..7]
 //
+// Mesure de l'attente (option de compilation LCD_MESURE) :
+//   Le temps pass  attendre le drapeau busy du contrleur est mesur
+//   avec le Timer1 de la base de temps, dmarr par temps_init()
+//   (voir iut_temps.h), 1 pas = 0,667 us.
+//   Une copie de l'cran (2 lignes de 16 caractres) est tenue  jour
+//   en RAM pour vrifier ce qui est affich sans regarder l'cran.
+//
+//   void lcd_mesure_lire(struct lcd_mesure *m);
+//     Copie les statistiques d'attente
+//
+//   void lcd_mesure_effacer(void);
+//     Remet  zro les statistiques d'attente
+//
+//   const char *lcd_ecran(char ligne);
+//     Renvoie le contenu de la ligne 0 ou 1 (16 caractres + '\0')
+//
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "iut_lcd.h"
@@ -92,6 +108,30 @@ static void lcd_repete_n(unsigned char n, char c);
 #define lcd_delai_5ms()        _delay(60000)
 #define lcd_delai_100us()      _delay(1200)
 
+///////////////////////////////////////////////////////////////////////////////
+// Mesure de l'attente et copie de l'cran (option LCD_MESURE)
+///////////////////////////////////////////////////////////////////////////////
+#ifdef LCD_MESURE
+#include "iut_timers.h"
+
+static struct lcd_mesure lcd_stat;
+// Attente accumule depuis le dbut du lcd_printf en cours
+static unsigned int lcd_attente_printf;
+// Copie de la partie visible de la DDRAM et adresse courante du curseur
+static char lcd_copie[2][17];
+static unsigned char lcd_adresse;
+
+// Attente du drapeau busy, chronomtre
+static void lcd_attendre(void);
+// Mise  jour de la copie aprs une commande ou une donne
+static void lcd_copie_cmd(unsigned char c);
+static void lcd_copie_data(unsigned char c);
+#else
+#define lcd_attendre()      while (lcd_busy())
+#define lcd_copie_cmd(c)
+#define lcd_copie_data(c)
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 //  Nom de fonction  :  lcd_init
 //  Valeur de retour :  aucune
@@ -224,6 +264,9 @@ void lcd_printf(const char *f, ...) {
     unsigned char c;
     //    int count = 0;
 
+#ifdef LCD_MESURE
+    lcd_attente_printf = 0;
+#endif
     va_start(ap, f);
     for (c = *f; c; c = *++f) {
         if (c == '%') {
@@ -738,6 +781,14 @@ _do_integer_conversion:
     }
 
     va_end(ap);
+#ifdef LCD_MESURE
+    lcd_stat.nb_printf++;
+    lcd_stat.printf_derniere = lcd_attente_printf;
+    lcd_stat.printf_somme += lcd_attente_printf;
+    if (lcd_attente_printf > lcd_stat.printf_max) {
+        lcd_stat.printf_max = lcd_attente_printf;
+    }
+#endif
     //    return count;
 }
 
@@ -758,15 +809,17 @@ void lcd_write_cmd_data(unsigned char c) {
 }
 
 static void lcd_write_data_busy(unsigned char c) {
-    while (lcd_busy());
+    lcd_attendre();
     LCD_RS_PIN = 1;
     lcd_write_cmd_data(c);
+    lcd_copie_data(c);
 }
 
 static void lcd_write_cmd_busy(unsigned char c) {
-    while (lcd_busy());
+    lcd_attendre();
     LCD_RS_PIN = 0;
     lcd_write_cmd_data(c);
+    lcd_copie_cmd(c);
 }
 
 static unsigned char lcd_busy(void) {
@@ -801,6 +854,103 @@ static void lcd_repete_n(unsigned char n, char c) {
     while (n--) lcd_write_data_busy(c);
 }
 
+#ifdef LCD_MESURE
+
+static void lcd_attendre(void) {
+    unsigned int t0, d;
+
+    t0 = ReadTimer1();
+    while (lcd_busy());
+    d = ReadTimer1() - t0;
+    lcd_attente_printf += d;
+    lcd_stat.totale += d;
+}
+
+// Adresses DDRAM en mode 2 lignes : 0x00-0x27 puis 0x40-0x67,
+// seules les 16 premires de chaque ligne sont visibles
+static void lcd_copie_avancer(void) {
+    lcd_adresse++;
+    if (lcd_adresse == 0x28) lcd_adresse = 0x40;
+    else if (lcd_adresse == 0x68) lcd_adresse = 0x00;
+}
+
+static void lcd_copie_data(unsigned char c) {
+    if (lcd_adresse < 0x10) {
+        lcd_copie[0][lcd_adresse] = c;
+    } else if (lcd_adresse >= 0x40 && lcd_adresse < 0x50) {
+        lcd_copie[1][lcd_adresse - 0x40] = c;
+    }
+    lcd_copie_avancer();
+}
+
+static void lcd_copie_cmd(unsigned char c) {
+    unsigned char i;
+
+    if (c & 0x80) { // Set DDRAM address
+        lcd_adresse = c & 0x7f;
+    } else if (c == 0x01) { // Clear display
+        for (i = 0; i < 16; i++) {
+            lcd_copie[0][i] = ' ';
+            lcd_copie[1][i] = ' ';
+        }
+        lcd_adresse = 0;
+    } else if ((c & 0xfe) == 0x02) { // Return home
+        lcd_adresse = 0;
+    } else if ((c & 0xf8) == 0x10) { // Dplacement du curseur (S/C = 0)
+        if (c & 0x04) {
+            lcd_copie_avancer();
+        } else if (lcd_adresse == 0x00) {
+            lcd_adresse = 0x67;
+        } else if (lcd_adresse == 0x40) {
+            lcd_adresse = 0x27;
+        } else {
+            lcd_adresse--;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  lcd_mesure_lire
+//  Valeur de retour :  aucune
+//  Paramtres       :  struct lcd_mesure *m
+//                        structure recevant la copie des statistiques
+//  Description      :  copie les statistiques d'attente du drapeau busy
+///////////////////////////////////////////////////////////////////////////////
+
+void lcd_mesure_lire(struct lcd_mesure *m) {
+    *m = lcd_stat;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  lcd_mesure_effacer
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  remet  zro les statistiques d'attente
+///////////////////////////////////////////////////////////////////////////////
+
+void lcd_mesure_effacer(void) {
+    lcd_stat.nb_printf = 0;
+    lcd_stat.printf_derniere = 0;
+    lcd_stat.printf_max = 0;
+    lcd_stat.printf_somme = 0;
+    lcd_stat.totale = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  lcd_ecran
+//  Valeur de retour :  const char *  =>  16 caractres termins par '\0'
+//  Paramtres       :  char ligne
+//                        numro de la ligne (0 ou 1)
+//  Description      :  renvoie la copie en RAM d'une ligne de l'cran,
+//                      telle que le contrleur l'affiche
+///////////////////////////////////////////////////////////////////////////////
+
+const char *lcd_ecran(char ligne) {
+    return lcd_copie[ligne != 0];
+}
+
+#endif
+
 
 ///////////////////////////////////////////////////////////////////////////////
 //
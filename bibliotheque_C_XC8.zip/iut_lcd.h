@@ -46,6 +46,22 @@
 //     D3   -    non connecte
 //   D4-D7  -    Data[4..7]
 //
+// Mesure de l'attente (option de compilation LCD_MESURE) :
+//   Le temps pass  attendre le drapeau busy du contrleur est mesur
+//   avec le Timer1 de la base de temps, dmarr par temps_init()
+//   (voir iut_temps.h), 1 pas = 0,667 us.
+//   Une copie de l'cran (2 lignes de 16 caractres) est tenue  jour
+//   en RAM pour vrifier ce qui est affich sans regarder l'cran.
+//
+//   void lcd_mesure_lire(struct lcd_mesure *m);
+//     Copie les statistiques d'attente
+//
+//   void lcd_mesure_effacer(void);
+//     Remet  zro les statistiques d'attente
+//
+//   const char *lcd_ecran(char ligne);
+//     Renvoie le contenu de la ligne 0 ou 1 (16 caractres + '\0')
+//
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <xc.h>
@@ -102,6 +118,46 @@ void lcd_putc(unsigned char lettre);
 ///////////////////////////////////////////////////////////////////////////////
 void lcd_printf(const char *f, ...);
 
+#ifdef LCD_MESURE
+
+// Statistiques d'attente du drapeau busy, dures en pas de Timer1
+struct lcd_mesure {
+    unsigned int nb_printf;         // nombre d'appels  lcd_printf
+    unsigned int printf_derniere;   // attente pendant le dernier lcd_printf
+    unsigned int printf_max;        // attente maximale pendant un lcd_printf
+    unsigned long printf_somme;     // attente cumule pendant les lcd_printf
+    unsigned long totale;           // attente cumule, toutes fonctions
+};
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  lcd_mesure_lire
+//  Valeur de retour :  aucune
+//  Paramtres       :  struct lcd_mesure *m
+//                        structure recevant la copie des statistiques
+//  Description      :  copie les statistiques d'attente du drapeau busy
+///////////////////////////////////////////////////////////////////////////////
+void lcd_mesure_lire(struct lcd_mesure *m);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  lcd_mesure_effacer
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  remet  zro les statistiques d'attente
+///////////////////////////////////////////////////////////////////////////////
+void lcd_mesure_effacer(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  lcd_ecran
+//  Valeur de retour :  const char *  =>  16 caractres termins par '\0'
+//  Paramtres       :  char ligne
+//                        numro de la ligne (0 ou 1)
+//  Description      :  renvoie la copie en RAM d'une ligne de l'cran,
+//                      telle que le contrleur l'affiche
+///////////////////////////////////////////////////////////////////////////////
+const char *lcd_ecran(char ligne);
+
+#endif
+
 
 ///////////////////////////////////////////////////////////////////////////////
 //
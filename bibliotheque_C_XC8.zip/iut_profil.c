@@ -0,0 +1,179 @@
+///////////////////////////////////////////////////////////////////////////////
+// Mesure des dures d'excution par tape (profilage)
+//
+// IUT de Cachan
+// Version 10/2026 pour xc8
+//
+// Voir iut_profil.h pour la description des macros disponibles.
+// Ce fichier est vide si le symbole PROFIL n'est pas dfini.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "iut_profil.h"
+
+#ifdef PROFIL
+
+#include "iut_timers.h"
+#include "iut_lcd.h"
+#include "iut_uart.h"
+
+// Statistiques d'une tape, dures en pas de Timer1 (8 cycles instruction)
+struct profil_etape {
+    const char *nom;
+    unsigned int debut;
+    unsigned int nombre;
+    unsigned int min;
+    unsigned int max;
+    unsigned long somme;
+};
+
+static struct profil_etape profil_table[PROFIL_NB_ETAPES];
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  profil_init
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  efface la table et les noms des tapes
+///////////////////////////////////////////////////////////////////////////////
+
+void profil_init(void) {
+    unsigned char i;
+
+    for (i = 0; i < PROFIL_NB_ETAPES; i++) {
+        profil_table[i].nom = 0;
+    }
+    profil_effacer();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  profil_nommer
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned char etape
+//                        numro de l'tape (0  PROFIL_NB_ETAPES - 1)
+//                      const char *nom
+//                        nom de l'tape, affich et envoy
+//  Description      :  associe un nom  une tape ; seules les tapes
+//                      nommes sont envoyes par profil_envoyer
+///////////////////////////////////////////////////////////////////////////////
+
+void profil_nommer(unsigned char etape, const char *nom) {
+    if (etape < PROFIL_NB_ETAPES) {
+        profil_table[etape].nom = nom;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  profil_debut
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned char etape
+//  Description      :  mmorise la valeur du Timer1 au dbut de l'tape
+///////////////////////////////////////////////////////////////////////////////
+
+void profil_debut(unsigned char etape) {
+    profil_table[etape].debut = ReadTimer1();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  profil_fin
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned char etape
+//  Description      :  calcule la dure depuis profil_debut et met  jour
+//                      nombre, min, max et somme de l'tape
+///////////////////////////////////////////////////////////////////////////////
+
+void profil_fin(unsigned char etape) {
+    struct profil_etape *p = &profil_table[etape];
+    unsigned int duree;
+
+    // La soustraction non signe reste juste au passage de 0xFFFF  0
+    duree = ReadTimer1() - p->debut;
+
+    if (p->nombre == 0xFFFF) return; // table pleine, la moyenne reste juste
+    p->nombre++;
+    p->somme += duree;
+    if (duree < p->min) p->min = duree;
+    if (duree > p->max) p->max = duree;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  profil_effacer
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  remet  zro les statistiques de toutes les tapes
+//                      (les noms sont conservs)
+///////////////////////////////////////////////////////////////////////////////
+
+void profil_effacer(void) {
+    unsigned char i;
+
+    for (i = 0; i < PROFIL_NB_ETAPES; i++) {
+        profil_table[i].nombre = 0;
+        profil_table[i].min = 0xFFFF;
+        profil_table[i].max = 0;
+        profil_table[i].somme = 0;
+    }
+}
+
+// Conversion d'une dure en pas de Timer1 vers des microsecondes (x 2/3)
+static unsigned int profil_us(unsigned long pas) {
+    return (unsigned int) ((pas * 2) / 3);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  profil_afficher
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned char etape
+//  Description      :  affiche sur les 2 lignes du LCD la dure moyenne,
+//                      min et max de l'tape en microsecondes
+///////////////////////////////////////////////////////////////////////////////
+
+void profil_afficher(unsigned char etape) {
+    struct profil_etape *p;
+    unsigned int moy = 0, min = 0;
+
+    if (etape >= PROFIL_NB_ETAPES) return;
+    p = &profil_table[etape];
+    if (p->nombre) {
+        moy = profil_us(p->somme / p->nombre);
+        min = profil_us(p->min);
+    }
+
+    lcd_position(0, 0);
+    if (p->nom) {
+        lcd_printf("%-7S moy%5u", p->nom, moy);
+    } else {
+        lcd_printf("etape%d  moy%5u", etape, moy);
+    }
+    lcd_position(1, 0);
+    lcd_printf("min%5umax%5u", min, profil_us(p->max));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  profil_envoyer
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  envoie sur la liaison srie une ligne par tape
+//                      nomme : nom;nombre;min;max;moyenne
+//                      dures en cycles instruction (1 cycle = 83,3 ns)
+///////////////////////////////////////////////////////////////////////////////
+
+void profil_envoyer(void) {
+    unsigned char i;
+    struct profil_etape *p;
+
+    for (i = 0; i < PROFIL_NB_ETAPES; i++) {
+        p = &profil_table[i];
+        if (p->nom == 0) continue;
+        uart_puts(p->nom);
+        uart_putc(';');
+        uart_putu(p->nombre);
+        uart_putc(';');
+        uart_putu(p->nombre ? 8UL * p->min : 0);
+        uart_putc(';');
+        uart_putu(8UL * p->max);
+        uart_putc(';');
+        uart_putu(p->nombre ? 8UL * (p->somme / p->nombre) : 0);
+        uart_puts("\r\n");
+    }
+}
+
+#endif
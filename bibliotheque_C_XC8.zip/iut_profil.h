@@ -0,0 +1,141 @@
+#ifndef __IUT_PROFIL_H
+#define __IUT_PROFIL_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Mesure des dures d'excution par tape (profilage)
+//
+// IUT de Cachan
+// Version 10/2026 pour xc8
+//
+// Les dures sont lues sur le Timer1 de la base de temps (iut_temps.h),
+// qui doit avoir t dmarr par temps_init() :
+// 1 pas de Timer1 = 8 cycles instruction = 0,667 us pour Fosc = 48 MHz.
+// Une tape ne doit pas durer plus de 65535 pas, soit environ 43 ms.
+//
+// Pour chaque tape, repre par un numro de 0  PROFIL_NB_ETAPES - 1,
+// la table conserve le nombre de mesures, la dure min, max et la somme.
+//
+// Le profilage n'est compil que si le symbole PROFIL est dfini
+// (option -DPROFIL du projet). Sinon les macros ci-dessous ne gnrent
+// aucun code.
+//
+// Macros disponibles
+//
+//   PROFIL_INIT();
+//     Efface la table
+//
+//   PROFIL_NOMMER(etape, nom);
+//     Donne un nom (chaine constante, 7 caractres au plus)  une tape
+//
+//   PROFIL_DEBUT(etape);  ...  PROFIL_FIN(etape);
+//     Encadre le code  mesurer
+//
+//   PROFIL_EFFACER();
+//     Remet  zro toutes les statistiques
+//
+//   PROFIL_AFFICHER(etape);
+//     Affiche sur le LCD les statistiques d'une tape (en us)
+//       ligne 0 - nom     moy xxxxx
+//       ligne 1 - min xxxxxmax xxxxx
+//
+//   PROFIL_ENVOYER();
+//     Envoie la table sur la liaison srie (uart_init doit avoir t appel)
+//     une ligne par tape nomme, dures en cycles instruction :
+//       nom;nombre;min;max;moyenne
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <xc.h>
+
+#ifndef PROFIL_NB_ETAPES
+#define PROFIL_NB_ETAPES 8
+#endif
+
+#ifdef PROFIL
+
+#define PROFIL_INIT()               profil_init()
+#define PROFIL_NOMMER(etape, nom)   profil_nommer(etape, nom)
+#define PROFIL_DEBUT(etape)         profil_debut(etape)
+#define PROFIL_FIN(etape)           profil_fin(etape)
+#define PROFIL_EFFACER()            profil_effacer()
+#define PROFIL_AFFICHER(etape)      profil_afficher(etape)
+#define PROFIL_ENVOYER()            profil_envoyer()
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  profil_init
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  efface la table et les noms des tapes
+///////////////////////////////////////////////////////////////////////////////
+void profil_init(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  profil_nommer
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned char etape
+//                        numro de l'tape (0  PROFIL_NB_ETAPES - 1)
+//                      const char *nom
+//                        nom de l'tape, affich et envoy
+//  Description      :  associe un nom  une tape ; seules les tapes
+//                      nommes sont envoyes par profil_envoyer
+///////////////////////////////////////////////////////////////////////////////
+void profil_nommer(unsigned char etape, const char *nom);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  profil_debut
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned char etape
+//  Description      :  mmorise la valeur du Timer1 au dbut de l'tape
+///////////////////////////////////////////////////////////////////////////////
+void profil_debut(unsigned char etape);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  profil_fin
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned char etape
+//  Description      :  calcule la dure depuis profil_debut et met  jour
+//                      nombre, min, max et somme de l'tape
+///////////////////////////////////////////////////////////////////////////////
+void profil_fin(unsigned char etape);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  profil_effacer
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  remet  zro les statistiques de toutes les tapes
+//                      (les noms sont conservs)
+///////////////////////////////////////////////////////////////////////////////
+void profil_effacer(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  profil_afficher
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned char etape
+//  Description      :  affiche sur les 2 lignes du LCD la dure moyenne,
+//                      min et max de l'tape en microsecondes
+///////////////////////////////////////////////////////////////////////////////
+void profil_afficher(unsigned char etape);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  profil_envoyer
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  envoie sur la liaison srie une ligne par tape
+//                      nomme : nom;nombre;min;max;moyenne
+//                      dures en cycles instruction (1 cycle = 83,3 ns)
+///////////////////////////////////////////////////////////////////////////////
+void profil_envoyer(void);
+
+#else
+
+#define PROFIL_INIT()
+#define PROFIL_NOMMER(etape, nom)
+#define PROFIL_DEBUT(etape)
+#define PROFIL_FIN(etape)
+#define PROFIL_EFFACER()
+#define PROFIL_AFFICHER(etape)
+#define PROFIL_ENVOYER()
+
+#endif
+
+#endif
@@ -0,0 +1,210 @@
+///////////////////////////////////////////////////////////////////////////////
+// Ordonnanceur coopratif de tches priodiques
+//
+// IUT de Cachan
+// Version 10/2026 pour xc8
+//
+// Voir iut_taches.h pour la description des fonctions disponibles.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "iut_taches.h"
+#include "iut_uart.h"
+
+// Etat d'une tche en RAM
+struct tache_etat {
+    struct pt pt;
+    unsigned int activation;    // tic de la dernire activation
+    char active;                // active, pas encore termine
+    struct tache_stat stat;
+};
+
+static const struct tache *taches_table;
+static unsigned char taches_nb;
+static struct tache_etat taches_etats[TACHES_MAX];
+static volatile unsigned int taches_compteur;
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  taches_init
+//  Valeur de retour :  aucune
+//  Paramtres       :  const struct tache *table
+//                        tches par ordre de priorit dcroissante
+//                      unsigned char nb
+//                        nombre de tches (TACHES_MAX au plus)
+//  Description      :  efface les compteurs et active toutes les tches
+///////////////////////////////////////////////////////////////////////////////
+
+void taches_init(const struct tache *table, unsigned char nb) {
+    unsigned char n;
+    unsigned int t = taches_tics();
+
+    if (nb > TACHES_MAX) nb = TACHES_MAX;
+    taches_table = table;
+    taches_nb = nb;
+    for (n = 0; n < nb; n++) {
+        taches_etats[n].pt.ligne = 0;
+        taches_etats[n].activation = t;
+        taches_etats[n].active = 0;
+    }
+    taches_effacer();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  taches_tic
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  compte un tic,  appeler depuis la routine
+//                      d'interruption du tic priodique
+///////////////////////////////////////////////////////////////////////////////
+
+void taches_tic(void) {
+    taches_compteur++;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  taches_executer
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  active les tches dont la priode est coule et
+//                      appelle une fois la plus prioritaire des tches
+//                      actives, puis la suivante si elle attend ; 
+//                      appeler sans fin dans main()
+///////////////////////////////////////////////////////////////////////////////
+
+void taches_executer(void) {
+    unsigned char n;
+    unsigned int t, reponse;
+    char r;
+    struct tache_etat *e;
+    const struct tache *d;
+
+    t = taches_tics();
+    for (n = 0; n < taches_nb; n++) {
+        e = &taches_etats[n];
+        if (!e->active) {
+            // cart sign : le compteur de tics reboucle
+            if ((int) (t - e->activation) < 0) continue;
+            e->active = 1;
+        }
+
+        // Tche prte la plus prioritaire : un pas, puis on rend la main,
+        // sauf si elle attend une condition : la suivante avance
+        d = &taches_table[n];
+        r = d->fonction(&e->pt);
+        if (r == PT_ATTENTE) continue;
+        if (r == PT_TERMINE) {
+            e->active = 0;
+            reponse = taches_tics() - e->activation;
+            e->stat.nombre++;
+            if (reponse > e->stat.reponse_max) e->stat.reponse_max = reponse;
+            if (reponse > d->echeance) e->stat.depassements++;
+
+            // Activation suivante une priode aprs la prcdente, sans
+            // drive ; plus d'une priode de retard : les activations
+            // manques sont perdues
+            e->activation += d->periode;
+            if ((int) (t - e->activation) >= (int) d->periode) {
+                e->activation = t;
+                e->stat.depassements++;
+            }
+        }
+        return;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  taches_tics
+//  Valeur de retour :  unsigned int  =>  nombre de tics (modulo 65536)
+//  Paramtres       :  aucun
+//  Description      :  lecture cohrente du compteur de tics
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int taches_tics(void) {
+    unsigned int t;
+
+    // Lecture 16 bits en 2 fois : on relit si un tic est pass entre
+    do {
+        t = taches_compteur;
+    } while (t != taches_compteur);
+    return t;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  taches_stat
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned char n
+//                        rang de la tche dans la table
+//                      struct tache_stat *s
+//                        copie des compteurs de la tche
+//  Description      :  lecture des compteurs d'une tche
+///////////////////////////////////////////////////////////////////////////////
+
+void taches_stat(unsigned char n, struct tache_stat *s) {
+    if (n < taches_nb) *s = taches_etats[n].stat;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  taches_effacer
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  remet  zro les compteurs de toutes les tches
+///////////////////////////////////////////////////////////////////////////////
+
+void taches_effacer(void) {
+    unsigned char n;
+
+    for (n = 0; n < taches_nb; n++) {
+        taches_etats[n].stat.nombre = 0;
+        taches_etats[n].stat.depassements = 0;
+        taches_etats[n].stat.reponse_max = 0;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  taches_envoyer
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  envoie sur la liaison srie une ligne par tche :
+//                      nom;nombre;depassements;reponse_max
+//                      uart_init doit avoir t appel
+///////////////////////////////////////////////////////////////////////////////
+
+void taches_envoyer(void) {
+    unsigned char n;
+    struct tache_stat *s;
+
+    for (n = 0; n < taches_nb; n++) {
+        s = &taches_etats[n].stat;
+        uart_puts(taches_table[n].nom);
+        uart_putc(';');
+        uart_putu(s->nombre);
+        uart_putc(';');
+        uart_putu(s->depassements);
+        uart_putc(';');
+        uart_putu(s->reponse_max);
+        uart_puts("\r\n");
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  minuterie_armer
+//  Valeur de retour :  aucune
+//  Paramtres       :  struct minuterie *m
+//                      unsigned int tics
+//                        dure en tics (32767 au plus)
+//  Description      :  la minuterie sera chue dans tics tics
+///////////////////////////////////////////////////////////////////////////////
+
+void minuterie_armer(struct minuterie *m, unsigned int tics) {
+    m->fin = taches_tics() + tics;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  minuterie_echue
+//  Valeur de retour :  char  =>  1 si la dure est coule, 0 sinon
+//  Paramtres       :  struct minuterie *m
+//  Description      :   utiliser avec PT_ATTENDRE_QUE
+///////////////////////////////////////////////////////////////////////////////
+
+char minuterie_echue(struct minuterie *m) {
+    return (int) (taches_tics() - m->fin) >= 0;
+}
@@ -0,0 +1,207 @@
+#ifndef __IUT_TACHES_H
+#define __IUT_TACHES_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Ordonnanceur coopratif de tches priodiques
+//
+// IUT de Cachan
+// Version 10/2026 pour xc8
+//
+// Les tches sont dcrites dans une table constante (en mmoire programme),
+// dans l'ordre de priorit : la premire est la plus prioritaire. Chaque
+// tche a une priode et une chance, en tics. Le tic est compt par
+// taches_tic(),  appeler depuis un tic priodique (it_tic_init, iut_it.h).
+//
+// La boucle principale appelle taches_executer() sans fin. A chaque appel,
+// la tche prte la plus prioritaire avance d'un pas. Une tche est une
+// "protothread" : elle peut rendre la main au milieu de son travail
+// (PT_CEDER, PT_ATTENDRE_QUE) et reprend au mme endroit  l'appel
+// suivant, ce qui permet de couper un affichage LCD en plusieurs pas
+// sans retarder les tches plus prioritaires.
+// Une tche arrte sur PT_ATTENDRE_QUE ne fait rien : les tches
+// suivantes avancent dans le mme appel, elle ne les bloque pas. Aprs
+// PT_CEDER, la main revient  la boucle principale.
+// Attention : les variables locales d'une tche ne sont pas conserves
+// quand elle rend la main, utiliser des variables static. Les macros PT_
+// utilisent le numro de ligne : une seule par ligne de source.
+//
+// Pour chaque tche sont compts : le nombre d'excutions termines, le
+// nombre d'chances dpasses (temps de rponse > chance ou activation
+// perdue) et le plus long temps de rponse, en tics.
+//
+// Fonctions disponibles
+//
+//   void taches_init(const struct tache *table, unsigned char nb);
+//     Toutes les tches sont actives au premier tic
+//
+//   void taches_tic(void);
+//     Compte un tic, depuis la routine du tic priodique
+//
+//   void taches_executer(void);
+//     Fait avancer d'un pas la tche prte la plus prioritaire, puis les
+//     suivantes tant que les prcdentes attendent (PT_ATTENDRE_QUE)
+//
+//   unsigned int taches_tics(void);
+//     Nombre de tics depuis taches_init (modulo 65536)
+//
+//   void taches_stat(unsigned char n, struct tache_stat *s);
+//   void taches_effacer(void);
+//   void taches_envoyer(void);
+//     Lecture, remise  zro et envoi sur la liaison srie des compteurs
+//       nom;nombre;depassements;reponse_max
+//
+//   void minuterie_armer(struct minuterie *m, unsigned int tics);
+//   char minuterie_echue(struct minuterie *m);
+//     Minuteries logicielles sur le tic
+//
+// Exemple de tche
+//
+//   char affichage(struct pt *pt) {
+//       PT_DEBUT(pt);
+//       lcd_position(0, 0);
+//       lcd_printf("ligne 0");
+//       PT_CEDER(pt);            // les tches prioritaires passent ici
+//       lcd_position(1, 0);
+//       lcd_printf("ligne 1");
+//       PT_FIN(pt);
+//   }
+//
+//   const struct tache taches[] = {
+//       {"affichage", affichage, 100, 100},   // 10 Hz pour un tic de 1 ms
+//   };
+//   taches_init(taches, 1);
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <xc.h>
+
+#ifndef TACHES_MAX
+#define TACHES_MAX 8
+#endif
+
+// Contexte d'une protothread : numro de ligne o reprendre
+struct pt {
+    unsigned int ligne;
+};
+
+// Valeurs renvoyes par une tche
+#define PT_EN_COURS 0   // a rendu la main,  rappeler
+#define PT_TERMINE  1   // excution termine jusqu' la prochaine priode
+#define PT_ATTENTE  2   // condition fausse,  rappeler ; les suivantes passent
+
+#define PT_DEBUT(pt)    switch ((pt)->ligne) { case 0:
+
+#define PT_CEDER(pt) \
+    do { (pt)->ligne = __LINE__; return PT_EN_COURS; case __LINE__:; } while (0)
+
+#define PT_ATTENDRE_QUE(pt, condition) \
+    do { (pt)->ligne = __LINE__; case __LINE__: \
+        if (!(condition)) return PT_ATTENTE; } while (0)
+
+#define PT_FIN(pt)      } (pt)->ligne = 0; return PT_TERMINE
+
+// Description d'une tche, priodes et chances en tics
+struct tache {
+    const char *nom;
+    char (*fonction)(struct pt *pt);
+    unsigned int periode;
+    unsigned int echeance;  // temps de rponse maximal aprs activation
+};
+
+struct tache_stat {
+    unsigned long nombre;       // excutions termines
+    unsigned int depassements;  // chances dpasses
+    unsigned int reponse_max;   // en tics
+};
+
+struct minuterie {
+    unsigned int fin;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  taches_init
+//  Valeur de retour :  aucune
+//  Paramtres       :  const struct tache *table
+//                        tches par ordre de priorit dcroissante
+//                      unsigned char nb
+//                        nombre de tches (TACHES_MAX au plus)
+//  Description      :  efface les compteurs et active toutes les tches
+///////////////////////////////////////////////////////////////////////////////
+void taches_init(const struct tache *table, unsigned char nb);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  taches_tic
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  compte un tic,  appeler depuis la routine
+//                      d'interruption du tic priodique
+///////////////////////////////////////////////////////////////////////////////
+void taches_tic(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  taches_executer
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  active les tches dont la priode est coule et
+//                      appelle une fois la plus prioritaire des tches
+//                      actives, puis la suivante si elle attend ; 
+//                      appeler sans fin dans main()
+///////////////////////////////////////////////////////////////////////////////
+void taches_executer(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  taches_tics
+//  Valeur de retour :  unsigned int  =>  nombre de tics (modulo 65536)
+//  Paramtres       :  aucun
+//  Description      :  lecture cohrente du compteur de tics
+///////////////////////////////////////////////////////////////////////////////
+unsigned int taches_tics(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  taches_stat
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned char n
+//                        rang de la tche dans la table
+//                      struct tache_stat *s
+//                        copie des compteurs de la tche
+//  Description      :  lecture des compteurs d'une tche
+///////////////////////////////////////////////////////////////////////////////
+void taches_stat(unsigned char n, struct tache_stat *s);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  taches_effacer
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  remet  zro les compteurs de toutes les tches
+///////////////////////////////////////////////////////////////////////////////
+void taches_effacer(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  taches_envoyer
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  envoie sur la liaison srie une ligne par tche :
+//                      nom;nombre;depassements;reponse_max
+//                      uart_init doit avoir t appel
+///////////////////////////////////////////////////////////////////////////////
+void taches_envoyer(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  minuterie_armer
+//  Valeur de retour :  aucune
+//  Paramtres       :  struct minuterie *m
+//                      unsigned int tics
+//                        dure en tics (32767 au plus)
+//  Description      :  la minuterie sera chue dans tics tics
+///////////////////////////////////////////////////////////////////////////////
+void minuterie_armer(struct minuterie *m, unsigned int tics);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  minuterie_echue
+//  Valeur de retour :  char  =>  1 si la dure est coule, 0 sinon
+//  Paramtres       :  struct minuterie *m
+//  Description      :   utiliser avec PT_ATTENDRE_QUE
+///////////////////////////////////////////////////////////////////////////////
+char minuterie_echue(struct minuterie *m);
+
+#endif
@@ -0,0 +1,71 @@
+///////////////////////////////////////////////////////////////////////////////
+// Base de temps 32 bits sur le Timer1
+//
+// IUT de Cachan
+// Version 10/2026 pour xc8
+//
+// Voir iut_temps.h pour la description des fonctions disponibles.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "iut_temps.h"
+#include "iut_timers.h"
+
+// 16 bits de poids fort, incrments  chaque dbordement du Timer1
+static volatile unsigned int temps_haut;
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  temps_init
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  dmarre le Timer1 en comptage libre 16 bits,
+//                      prescaler 1:8, interruption de dbordement active
+///////////////////////////////////////////////////////////////////////////////
+
+void temps_init(void) {
+    temps_haut = 0;
+    OpenTimer1(TIMER_INT_ON & T1_16BIT_RW & T1_SOURCE_INT & T1_PS_1_8
+            & T1_OSC1EN_OFF & T1_SYNC_EXT_OFF);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  temps_lire
+//  Valeur de retour :  unsigned long  =>  temps coul en pas de 0,667 us
+//  Paramtres       :  aucun
+//  Description      :  assemble les 16 bits compts par interruption et
+//                      le Timer1, en tenant compte d'un dbordement pas
+//                      encore trait
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned long temps_lire(void) {
+    unsigned int haut, bas;
+    unsigned char retenue;
+
+    // Si l'interruption passe pendant la lecture, temps_haut a chang :
+    // on recommence
+    do {
+        haut = temps_haut;
+        bas = ReadTimer1();
+        // Dbordement pas encore trait (appel depuis une interruption
+        // ou interruptions masques) : le Timer1 vient de repasser  0
+        retenue = PIR1bits.TMR1IF && (bas < 0x8000);
+    } while (haut != temps_haut);
+    if (retenue) haut++;
+
+    return ((unsigned long) haut << 16) | bas;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  temps_it
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  traitement du dbordement du Timer1,  appeler
+//                      depuis la routine d'interruption du niveau le
+//                      plus lev o temps_lire est appel (priorit
+//                      haute) : sinon une lecture peut tomber entre
+//                      l'effacement du drapeau et l'incrment
+///////////////////////////////////////////////////////////////////////////////
+
+void temps_it(void) {
+    PIR1bits.TMR1IF = 0;
+    temps_haut++;
+}
@@ -0,0 +1,71 @@
+#ifndef __IUT_TEMPS_H
+#define __IUT_TEMPS_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Base de temps 32 bits sur le Timer1
+//
+// IUT de Cachan
+// Version 10/2026 pour xc8
+//
+// Le Timer1 tourne librement (horloge interne, prescaler 1:8) et son
+// dbordement, toutes les 43,7 ms, incrmente les 16 bits de poids fort.
+// 1 pas = 8 cycles instruction = 0,667 us pour Fosc = 48 MHz,
+// la base de temps repasse  0 au bout de 47 minutes environ.
+//
+// Fonctions disponibles
+//
+//   void temps_init(void);
+//     Dmarre le Timer1 avec son interruption de dbordement.
+//     Les interruptions doivent ensuite tre autorises (GIE, PEIE).
+//
+//   unsigned long temps_lire(void);
+//     Renvoie le temps coul en pas de 0,667 us. Utilisable dans le
+//     programme principal comme dans une routine d'interruption.
+//
+//   void temps_it(void);
+//     A appeler depuis la routine d'interruption quand PIR1bits.TMR1IF = 1
+//
+// Les dures se calculent par diffrence, en non sign :
+//   duree = temps_lire() - debut;
+//
+// Pour plus d'informations, consultez p18f4550_39632e.pdf 12
+///////////////////////////////////////////////////////////////////////////////
+
+#include <xc.h>
+
+// Nombre de pas de la base de temps par milliseconde et par seconde
+#define TEMPS_PAR_MS    1500UL
+#define TEMPS_PAR_S     1500000UL
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  temps_init
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  dmarre le Timer1 en comptage libre 16 bits,
+//                      prescaler 1:8, interruption de dbordement active
+///////////////////////////////////////////////////////////////////////////////
+void temps_init(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  temps_lire
+//  Valeur de retour :  unsigned long  =>  temps coul en pas de 0,667 us
+//  Paramtres       :  aucun
+//  Description      :  assemble les 16 bits compts par interruption et
+//                      le Timer1, en tenant compte d'un dbordement pas
+//                      encore trait
+///////////////////////////////////////////////////////////////////////////////
+unsigned long temps_lire(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  temps_it
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  traitement du dbordement du Timer1,  appeler
+//                      depuis la routine d'interruption du niveau le
+//                      plus lev o temps_lire est appel (priorit
+//                      haute) : sinon une lecture peut tomber entre
+//                      l'effacement du drapeau et l'incrment
+///////////////////////////////////////////////////////////////////////////////
+void temps_it(void);
+
+#endif
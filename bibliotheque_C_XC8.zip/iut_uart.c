@@ -0,0 +1,109 @@
+///////////////////////////////////////////////////////////////////////////////
+// Utilisation simplifie de la liaison srie (EUSART)
+//
+// IUT de Cachan
+// Version 10/2026 pour xc8
+//
+// Fonctions disponibles
+//
+//   void uart_init(unsigned long debit);
+//     Initialisation de la liaison srie asynchrone 8 bits, sans parit,
+//     1 bit de stop, au dbit demand en bauds (pour Fosc = 48 MHz)
+//       uart_init(115200);
+//
+//   void uart_putc(unsigned char c);
+//     Emission d'un octet, attente que le registre d'mission soit libre
+//
+//   void uart_puts(const char *chaine);
+//     Emission d'une chaine de caractres termine par '\0'
+//
+//   void uart_putu(unsigned long nombre);
+//     Emission d'un entier non sign en dcimal
+//
+//   Broche - Signal
+//     C6   -   TX
+//     C7   -   RX
+//
+// Pour plus d'informations, consultez p18f4550_39632e.pdf 20
+///////////////////////////////////////////////////////////////////////////////
+
+#include "iut_uart.h"
+
+// Frquence du cycle instruction pour Fosc = 48 MHz
+#define UART_FCY    12000000UL
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  uart_init
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned long debit
+//                        dbit en bauds, exemple : 9600, 115200
+//  Description      :  configuration de l'EUSART en mode asynchrone,
+//                      gnrateur de dbit 16 bits (BRG16 = 1, BRGH = 1)
+//                      SPBRGH:SPBRG = Fosc / (4 * debit) - 1
+///////////////////////////////////////////////////////////////////////////////
+
+void uart_init(unsigned long debit) {
+    unsigned int brg;
+
+    // Arrondi au plus proche de Fcy / debit - 1
+    brg = (unsigned int) ((UART_FCY + debit / 2) / debit - 1);
+
+    TRISCbits.TRISC6 = 1; // TX et RX en entres, l'EUSART prend la main
+    TRISCbits.TRISC7 = 1;
+
+    BAUDCONbits.BRG16 = 1;
+    SPBRGH = brg >> 8;
+    SPBRG = brg;
+
+    TXSTA = 0b00100100; // TXEN = 1, SYNC = 0, BRGH = 1
+    RCSTA = 0b10010000; // SPEN = 1, CREN = 1
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  uart_putc
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned char c
+//                        octet  mettre
+//  Description      :  attend que TXREG soit libre puis met l'octet
+///////////////////////////////////////////////////////////////////////////////
+
+void uart_putc(unsigned char c) {
+    while (!PIR1bits.TXIF);
+    TXREG = c;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  uart_puts
+//  Valeur de retour :  aucune
+//  Paramtres       :  const char *chaine
+//                        chaine termine par '\0'
+//  Description      :  met la chaine caractre par caractre
+///////////////////////////////////////////////////////////////////////////////
+
+void uart_puts(const char *chaine) {
+    while (*chaine) {
+        uart_putc(*chaine++);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  uart_putu
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned long nombre
+//                        entier non sign  mettre
+//  Description      :  met l'entier en dcimal, sans zros de tte
+///////////////////////////////////////////////////////////////////////////////
+
+void uart_putu(unsigned long nombre) {
+    // 4294967295 : 10 chiffres au maximum
+    char buf[10];
+    unsigned char n = 0;
+
+    do {
+        buf[n++] = '0' + (nombre % 10);
+        nombre /= 10;
+    } while (nombre);
+    while (n) {
+        uart_putc(buf[--n]);
+    }
+}
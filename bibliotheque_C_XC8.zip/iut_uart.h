@@ -0,0 +1,73 @@
+#ifndef __IUT_UART_H
+#define __IUT_UART_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Utilisation simplifie de la liaison srie (EUSART)
+//
+// IUT de Cachan
+// Version 10/2026 pour xc8
+//
+// Fonctions disponibles
+//
+//   void uart_init(unsigned long debit);
+//     Initialisation de la liaison srie asynchrone 8 bits, sans parit,
+//     1 bit de stop, au dbit demand en bauds (pour Fosc = 48 MHz)
+//       uart_init(115200);
+//
+//   void uart_putc(unsigned char c);
+//     Emission d'un octet, attente que le registre d'mission soit libre
+//
+//   void uart_puts(const char *chaine);
+//     Emission d'une chaine de caractres termine par '\0'
+//
+//   void uart_putu(unsigned long nombre);
+//     Emission d'un entier non sign en dcimal
+//
+//   Broche - Signal
+//     C6   -   TX
+//     C7   -   RX
+//
+// Pour plus d'informations, consultez p18f4550_39632e.pdf 20
+///////////////////////////////////////////////////////////////////////////////
+
+#include <xc.h>
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  uart_init
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned long debit
+//                        dbit en bauds, exemple : 9600, 115200
+//  Description      :  configuration de l'EUSART en mode asynchrone,
+//                      gnrateur de dbit 16 bits (BRG16 = 1, BRGH = 1)
+//                      SPBRGH:SPBRG = Fosc / (4 * debit) - 1
+///////////////////////////////////////////////////////////////////////////////
+void uart_init(unsigned long debit);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  uart_putc
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned char c
+//                        octet  mettre
+//  Description      :  attend que TXREG soit libre puis met l'octet
+///////////////////////////////////////////////////////////////////////////////
+void uart_putc(unsigned char c);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  uart_puts
+//  Valeur de retour :  aucune
+//  Paramtres       :  const char *chaine
+//                        chaine termine par '\0'
+//  Description      :  met la chaine caractre par caractre
+///////////////////////////////////////////////////////////////////////////////
+void uart_puts(const char *chaine);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  uart_putu
+//  Valeur de retour :  aucune
+//  Paramtres       :  unsigned long nombre
+//                        entier non sign  mettre
+//  Description      :  met l'entier en dcimal, sans zros de tte
+///////////////////////////////////////////////////////////////////////////////
+void uart_putu(unsigned long nombre);
+
+#endif
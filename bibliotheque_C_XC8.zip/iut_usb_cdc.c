@@ -0,0 +1,577 @@
+///////////////////////////////////////////////////////////////////////////////
+// Port srie virtuel sur l'USB (classe CDC-ACM, full speed)
+//
+// IUT de Cachan
+// Version 10/2026 pour xc8
+//
+// Voir iut_usb_cdc.h pour la description des fonctions disponibles.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "iut_usb_cdc.h"
+#include "iut_it.h"
+
+// Descripteur de tampon (BD) : tat, nombre d'octets, adresse du tampon
+struct usb_bd {
+    unsigned char stat;
+    unsigned char cnt;
+    unsigned int adr;
+};
+
+// Bits de stat crits par le programme ; au retour du module, les bits
+// 2  5 donnent le PID du paquet
+#define BD_UOWN     0x80    // descripteur au module USB
+#define BD_DTS      0x40    // paquet DATA1
+#define BD_DTSEN    0x08    // paquet  l'alternance DATA0/DATA1 fausse ignor
+#define BD_BSTALL   0x04    // rponse STALL
+#define BD_PID(s)   (((s) >> 2) & 0x0F)
+#define PID_SETUP   0x0D
+
+// Rangs dans la table des descripteurs, sans double tampon :
+// 2 x endpoint + sens (IN = 1)
+#define BD_EP0_OUT  0
+#define BD_EP0_IN   1
+#define BD_EP2_OUT  4
+#define BD_EP2_IN   5
+#define BD_NB       6
+
+#define EP0_TAILLE  8
+#define EP2_TAILLE  64
+
+// UEPn : EPHSHK, EPCONDIS, EPOUTEN, EPINEN
+#define UEP_CONTROLE    0x16
+#define UEP_IN          0x1A
+#define UEP_IN_OUT      0x1E
+
+#define AUCUNE_ADRESSE  0xFF
+
+// RAM du module USB (banque 4) : la table des descripteurs en 0x400, puis
+// les tampons des endpoints
+static volatile struct usb_bd usb_bdt[BD_NB] __at(0x400);
+static volatile unsigned char usb_ep0_out[EP0_TAILLE] __at(0x418);
+static volatile unsigned char usb_ep0_in[EP0_TAILLE] __at(0x420);
+static volatile unsigned char usb_ep2_out[EP2_TAILLE] __at(0x440);
+static volatile unsigned char usb_ep2_in[EP2_TAILLE] __at(0x480);
+
+///////////////////////////////////////////////////////////////////////////////
+// Descripteurs
+///////////////////////////////////////////////////////////////////////////////
+
+static const unsigned char usb_appareil[] = {
+    18, 0x01,               // DEVICE
+    0x00, 0x02,             // USB 2.0
+    0x02, 0x00, 0x00,       // classe CDC
+    EP0_TAILLE,
+    USB_CDC_VID & 0xFF, USB_CDC_VID >> 8,
+    USB_CDC_PID & 0xFF, USB_CDC_PID >> 8,
+    0x00, 0x01,             // version 1.00
+    1, 2, 0,                // chanes : fabricant, produit, pas de n de srie
+    1                       // une configuration
+};
+
+static const unsigned char usb_configuration_desc[] = {
+    9, 0x02,                // CONFIGURATION
+    67, 0,                  // longueur totale
+    2, 1, 0,                // 2 interfaces, configuration 1
+    0xC0, 50,               // alimentation propre, 100 mA au plus
+
+    9, 0x04,                // INTERFACE 0 : communication
+    0, 0, 1,
+    0x02, 0x02, 0x01, 0,    // CDC, ACM, commandes AT
+    5, 0x24, 0x00, 0x10, 0x01,  // en-tte CDC 1.10
+    4, 0x24, 0x02, 0x02,        // ACM : line coding et control line state
+    5, 0x24, 0x06, 0, 1,        // union : 0 matre, 1 esclave
+    5, 0x24, 0x01, 0x00, 1,     // gestion des appels : aucune
+    7, 0x05, 0x81, 0x03, 8, 0, 0xFF,    // EP1 IN interruption, jamais servi
+
+    9, 0x04,                // INTERFACE 1 : donnes
+    1, 0, 2,
+    0x0A, 0x00, 0x00, 0,
+    7, 0x05, 0x02, 0x02, EP2_TAILLE, 0, 0,  // EP2 OUT bulk
+    7, 0x05, 0x82, 0x02, EP2_TAILLE, 0, 0   // EP2 IN bulk
+};
+
+static const unsigned char usb_langue[] = {4, 0x03, 0x09, 0x04};
+
+static const unsigned char usb_fabricant[] = {
+    28, 0x03,
+    'I', 0, 'U', 0, 'T', 0, ' ', 0, 'd', 0, 'e', 0, ' ', 0,
+    'C', 0, 'a', 0, 'c', 0, 'h', 0, 'a', 0, 'n', 0
+};
+
+static const unsigned char usb_produit[] = {
+    34, 0x03,
+    'S', 0, 'u', 0, 'i', 0, 'v', 0, 'e', 0, 'u', 0, 'r', 0, ' ', 0,
+    'd', 0, 'e', 0, ' ', 0, 'l', 0, 'i', 0, 'g', 0, 'n', 0, 'e', 0
+};
+
+static const unsigned char *const usb_chaines[] = {
+    usb_langue, usb_fabricant, usb_produit
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Etat
+///////////////////////////////////////////////////////////////////////////////
+
+static volatile unsigned char usb_configuration;   // 0 : non configur
+static volatile unsigned char usb_dtr;             // port ouvert ct PC
+static unsigned char usb_nouvelle_adresse;         // prise aprs l'tat
+
+// Rponse en cours sur l'endpoint 0
+static const unsigned char *usb_ep0_source;
+static unsigned char usb_ep0_reste;
+static char usb_ep0_court;      // rponse plus courte que la demande
+static char usb_ep0_fin;        // dernier paquet de la rponse parti
+static unsigned char usb_ep0_dts;
+static unsigned char usb_reponse[2];
+
+// Line coding : dbit (poids faible en premier), stop, parit, bits
+static unsigned char usb_codage[7] = {0x00, 0xC2, 0x01, 0x00, 0, 0, 8};
+static char usb_codage_attendu;
+
+static unsigned char usb_ep2_dts_in, usb_ep2_dts_out;
+static char usb_ep2_plein;      // dernier paquet mis de 64 octets
+static char usb_ep2_recu;       // paquet reu pas encore copi
+
+// Tampons circulaires : les index de 8 bits ne sont pas rduits, leur
+// diffrence est le nombre d'octets rangs, de 0  la taille du tampon.
+// Un seul consommateur, qui seul crit la queue ; la tte est crite par
+// le producteur, en une fois aprs la copie.
+static unsigned char usb_emission[USB_CDC_EMISSION];
+static volatile unsigned char usb_emission_tete, usb_emission_queue;
+static unsigned char usb_reception[USB_CDC_RECEPTION];
+static volatile unsigned char usb_reception_tete, usb_reception_queue;
+
+///////////////////////////////////////////////////////////////////////////////
+// Endpoint 0 : numration et requtes CDC
+///////////////////////////////////////////////////////////////////////////////
+
+// Prt  recevoir SETUP, donnes ou tat, quelle que soit l'alternance
+static void usb_ep0_armer(void) {
+    usb_bdt[BD_EP0_OUT].cnt = EP0_TAILLE;
+    usb_bdt[BD_EP0_OUT].stat = BD_UOWN;
+}
+
+// Requte refuse : STALL jusqu'au prochain SETUP
+static void usb_ep0_bloquer(void) {
+    usb_bdt[BD_EP0_IN].stat = BD_UOWN | BD_BSTALL;
+    usb_bdt[BD_EP0_OUT].cnt = EP0_TAILLE;
+    usb_bdt[BD_EP0_OUT].stat = BD_UOWN | BD_BSTALL;
+}
+
+// Paquet suivant de la rponse ; la rponse se termine par un paquet
+// court (vide au besoin) si elle est plus courte que la demande
+static void usb_ep0_paquet(void) {
+    unsigned char n, i;
+
+    n = (usb_ep0_reste > EP0_TAILLE) ? EP0_TAILLE : usb_ep0_reste;
+    for (i = 0; i < n; i++) {
+        usb_ep0_in[i] = *usb_ep0_source++;
+    }
+    usb_ep0_reste -= n;
+    usb_ep0_fin = (n < EP0_TAILLE || (usb_ep0_reste == 0 && !usb_ep0_court));
+
+    usb_bdt[BD_EP0_IN].cnt = n;
+    usb_bdt[BD_EP0_IN].stat = BD_UOWN | BD_DTSEN | usb_ep0_dts;
+    usb_ep0_dts ^= BD_DTS;
+}
+
+// Etape de donnes IN de nb octets (demande : wLength), ou tape d'tat
+// seule avec nb = demande = 0
+static void usb_ep0_repondre(const unsigned char *source, unsigned char nb,
+        unsigned int demande) {
+    usb_ep0_source = source;
+    usb_ep0_court = (nb < demande);
+    usb_ep0_reste = usb_ep0_court ? nb : (unsigned char) demande;
+    usb_ep0_dts = BD_DTS;   // donnes et tat commencent en DATA1
+    usb_ep0_paquet();
+}
+
+static void usb_configurer(unsigned char configuration) {
+    usb_configuration = configuration;
+    usb_dtr = 0;
+    usb_bdt[BD_EP2_IN].stat = 0;
+    usb_bdt[BD_EP2_OUT].stat = 0;
+    if (!configuration) {
+        UEP1 = 0;
+        UEP2 = 0;
+        return;
+    }
+    UEP1 = UEP_IN;
+    UEP2 = UEP_IN_OUT;
+
+    usb_ep2_dts_in = 0;
+    usb_ep2_plein = 0;
+    usb_ep2_recu = 0;
+    usb_ep2_dts_out = BD_DTS;
+    usb_bdt[BD_EP2_OUT].cnt = EP2_TAILLE;
+    usb_bdt[BD_EP2_OUT].stat = BD_UOWN | BD_DTSEN;  // DATA0
+}
+
+static void usb_ep0_standard(unsigned char requete, unsigned char type,
+        unsigned char valeur, unsigned char descripteur,
+        unsigned int demande) {
+    const unsigned char *d;
+
+    switch (requete) {
+    case 0x00:  // GET_STATUS : alimentation propre pour l'appareil
+        usb_reponse[0] = ((type & 0x1F) == 0);
+        usb_reponse[1] = 0;
+        usb_ep0_repondre(usb_reponse, 2, demande);
+        break;
+    case 0x01:  // CLEAR_FEATURE
+    case 0x03:  // SET_FEATURE
+    case 0x0B:  // SET_INTERFACE
+        usb_ep0_repondre(0, 0, 0);
+        break;
+    case 0x05:  // SET_ADDRESS, prise aprs l'tape d'tat
+        usb_nouvelle_adresse = valeur & 0x7F;
+        usb_ep0_repondre(0, 0, 0);
+        break;
+    case 0x06:  // GET_DESCRIPTOR
+        if (descripteur == 0x01) {
+            usb_ep0_repondre(usb_appareil, sizeof(usb_appareil), demande);
+        } else if (descripteur == 0x02) {
+            usb_ep0_repondre(usb_configuration_desc,
+                    sizeof(usb_configuration_desc), demande);
+        } else if (descripteur == 0x03
+                && valeur < sizeof(usb_chaines) / sizeof(usb_chaines[0])) {
+            d = usb_chaines[valeur];
+            usb_ep0_repondre(d, d[0], demande);
+        } else {
+            usb_ep0_bloquer();
+        }
+        break;
+    case 0x08:  // GET_CONFIGURATION
+        usb_reponse[0] = usb_configuration;
+        usb_ep0_repondre(usb_reponse, 1, demande);
+        break;
+    case 0x09:  // SET_CONFIGURATION
+        if (valeur > 1) {
+            usb_ep0_bloquer();
+            break;
+        }
+        usb_configurer(valeur);
+        usb_ep0_repondre(0, 0, 0);
+        break;
+    case 0x0A:  // GET_INTERFACE : pas de rglage alternatif
+        usb_reponse[0] = 0;
+        usb_ep0_repondre(usb_reponse, 1, demande);
+        break;
+    default:
+        usb_ep0_bloquer();
+    }
+}
+
+static void usb_ep0_classe(unsigned char requete, unsigned char valeur,
+        unsigned int demande) {
+    switch (requete) {
+    case 0x20:  // SET_LINE_CODING : 7 octets de donnes  venir
+        usb_codage_attendu = 1;
+        break;
+    case 0x21:  // GET_LINE_CODING
+        usb_ep0_repondre(usb_codage, sizeof(usb_codage), demande);
+        break;
+    case 0x22:  // SET_CONTROL_LINE_STATE : bit 0 = DTR
+        usb_dtr = valeur & 0x01;
+        usb_ep0_repondre(0, 0, 0);
+        break;
+    default:
+        usb_ep0_bloquer();
+    }
+}
+
+static void usb_ep0_setup(void) {
+    unsigned char type = usb_ep0_out[0];
+    unsigned char requete = usb_ep0_out[1];
+    unsigned char valeur = usb_ep0_out[2];
+    unsigned char descripteur = usb_ep0_out[3];
+    unsigned int demande = usb_ep0_out[6] | ((unsigned int) usb_ep0_out[7] << 8);
+
+    // Un SETUP annule la rponse en cours
+    usb_bdt[BD_EP0_IN].stat = 0;
+    usb_codage_attendu = 0;
+    usb_ep0_armer();
+
+    switch (type & 0x60) {
+    case 0x00:
+        usb_ep0_standard(requete, type, valeur, descripteur, demande);
+        break;
+    case 0x20:
+        usb_ep0_classe(requete, valeur, demande);
+        break;
+    default:
+        usb_ep0_bloquer();
+    }
+
+    // Le module suspend les transactions aprs un SETUP
+    UCONbits.PKTDIS = 0;
+}
+
+// Paquet OUT hors SETUP : donnes de SET_LINE_CODING, ou tat d'une
+// rponse IN
+static void usb_ep0_donnees(void) {
+    unsigned char n, i;
+
+    if (usb_codage_attendu) {
+        usb_codage_attendu = 0;
+        n = usb_bdt[BD_EP0_OUT].cnt;
+        if (n > sizeof(usb_codage)) n = sizeof(usb_codage);
+        for (i = 0; i < n; i++) {
+            usb_codage[i] = usb_ep0_out[i];
+        }
+        usb_ep0_repondre(0, 0, 0);
+    }
+    usb_ep0_armer();
+}
+
+// Paquet IN parti
+static void usb_ep0_suite(void) {
+    if (usb_nouvelle_adresse != AUCUNE_ADRESSE) {
+        UADDR = usb_nouvelle_adresse;
+        usb_nouvelle_adresse = AUCUNE_ADRESSE;
+    }
+    if (!usb_ep0_fin) usb_ep0_paquet();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Endpoint 2 : donnes
+///////////////////////////////////////////////////////////////////////////////
+
+// Remplit l'endpoint IN s'il est libre ; un paquet de 64 octets est suivi
+// d'un paquet court, vide si le tampon l'est, pour terminer le transfert
+static void usb_ep2_emettre(void) {
+    unsigned char q, n, i;
+
+    if (!usb_configuration || (usb_bdt[BD_EP2_IN].stat & BD_UOWN)) return;
+    q = usb_emission_queue;
+    n = usb_emission_tete - q;
+    if (n > EP2_TAILLE) n = EP2_TAILLE;
+    if (n == 0 && !usb_ep2_plein) return;
+
+    for (i = 0; i < n; i++) {
+        usb_ep2_in[i] = usb_emission[q++ & (USB_CDC_EMISSION - 1)];
+    }
+    usb_emission_queue = q;
+    usb_ep2_plein = (n == EP2_TAILLE);
+
+    usb_bdt[BD_EP2_IN].cnt = n;
+    usb_bdt[BD_EP2_IN].stat = BD_UOWN | BD_DTSEN | usb_ep2_dts_in;
+    usb_ep2_dts_in ^= BD_DTS;
+}
+
+// Copie le paquet reu s'il tient dans le tampon, puis rarme l'endpoint ;
+// sinon le paquet attend et le PC reoit des NAK
+static void usb_ep2_recevoir(void) {
+    unsigned char t, n, i;
+
+    if (!usb_ep2_recu) return;
+    n = usb_bdt[BD_EP2_OUT].cnt;
+    t = usb_reception_tete;
+    if (USB_CDC_RECEPTION - (unsigned char) (t - usb_reception_queue) < n) {
+        return;
+    }
+    for (i = 0; i < n; i++) {
+        usb_reception[t++ & (USB_CDC_RECEPTION - 1)] = usb_ep2_out[i];
+    }
+    usb_reception_tete = t;
+    usb_ep2_recu = 0;
+
+    usb_bdt[BD_EP2_OUT].cnt = EP2_TAILLE;
+    usb_bdt[BD_EP2_OUT].stat = BD_UOWN | BD_DTSEN | usb_ep2_dts_out;
+    usb_ep2_dts_out ^= BD_DTS;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Interruption
+///////////////////////////////////////////////////////////////////////////////
+
+// Reset du bus : adresse 0, non configur, endpoint 0 prt
+static void usb_raz(void) {
+    unsigned char n;
+
+    UADDR = 0;
+    usb_nouvelle_adresse = AUCUNE_ADRESSE;
+    usb_configurer(0);
+
+    // File USTAT vide (4 entres au plus)
+    for (n = 0; n < 4 && UIRbits.TRNIF; n++) {
+        UIRbits.TRNIF = 0;
+        _delay(6);      // entre suivante prsente aprs quelques cycles
+    }
+
+    usb_bdt[BD_EP0_OUT].adr = (unsigned int) usb_ep0_out;
+    usb_bdt[BD_EP0_IN].adr = (unsigned int) usb_ep0_in;
+    usb_bdt[BD_EP2_OUT].adr = (unsigned int) usb_ep2_out;
+    usb_bdt[BD_EP2_IN].adr = (unsigned int) usb_ep2_in;
+    usb_bdt[BD_EP0_IN].stat = 0;
+    usb_ep0_armer();
+    UEP0 = UEP_CONTROLE;
+
+    UCONbits.PKTDIS = 0;
+    UIRbits.URSTIF = 0;
+}
+
+static void usb_it(void) {
+    unsigned char n, bd;
+
+    PIR2bits.USBIF = 0;
+
+    // Reprise aprs une suspension : l'horloge du module doit repartir
+    // avant que ACTVIF puisse tre effac
+    if (UIEbits.ACTVIE && UIRbits.ACTVIF) {
+        UCONbits.SUSPND = 0;
+        UIEbits.ACTVIE = 0;
+        while (UIRbits.ACTVIF) UIRbits.ACTVIF = 0;
+    }
+    if (UCONbits.SUSPND) return;
+
+    if (UIRbits.URSTIF) usb_raz();
+
+    // Bus inactif 3 ms (PC en veille, cble dbranch) : suspension
+    if (UIRbits.IDLEIF) {
+        UIEbits.ACTVIE = 1;
+        UIRbits.IDLEIF = 0;
+        UCONbits.SUSPND = 1;
+        return;
+    }
+
+    // Trame USB, toutes les ms : paquet en attente de place, mission
+    if (UIRbits.SOFIF) {
+        UIRbits.SOFIF = 0;
+        usb_ep2_recevoir();
+        usb_ep2_emettre();
+    }
+
+    for (n = 0; n < 4 && UIRbits.TRNIF; n++) {
+        bd = (USTAT >> 2) & 0x1F;   // endpoint et sens
+        UIRbits.TRNIF = 0;          // entre suivante de la file USTAT
+
+        switch (bd) {
+        case BD_EP0_OUT:
+            if (BD_PID(usb_bdt[BD_EP0_OUT].stat) == PID_SETUP) {
+                usb_ep0_setup();
+            } else {
+                usb_ep0_donnees();
+            }
+            break;
+        case BD_EP0_IN:
+            usb_ep0_suite();
+            break;
+        case BD_EP2_OUT:
+            usb_ep2_recu = 1;
+            usb_ep2_recevoir();
+            break;
+        case BD_EP2_IN:
+            usb_ep2_emettre();
+            break;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  usb_cdc_init
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  configure le module USB (full speed, rsistance de
+//                      tirage interne), enregistre l'interruption en
+//                      priorit basse et connecte le PIC au bus ;
+//                      l'numration se fait ensuite sous interruption
+///////////////////////////////////////////////////////////////////////////////
+
+void usb_cdc_init(void) {
+    UCON = 0;
+    UIE = 0;
+    UCFG = 0x14;    // UPUEN = 1, FSEN = 1, pas de double tampon
+    UIR = 0;
+    usb_raz();
+
+    UIEbits.URSTIE = 1;
+    UIEbits.TRNIE = 1;
+    UIEbits.IDLEIE = 1;
+    UIEbits.SOFIE = 1;
+    it_enregistrer(IT_USB, IT_BASSE, usb_it);
+    PIE2bits.USBIE = 1;
+
+    UCONbits.USBEN = 1; // D+ tir  3,3 V : le PC voit l'appareil
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  usb_cdc_pret
+//  Valeur de retour :  char  =>  1 si le PIC est configur et le port
+//                                ouvert ct PC (DTR), 0 sinon
+//  Paramtres       :  aucun
+//  Description      :  tat de la liaison
+///////////////////////////////////////////////////////////////////////////////
+
+char usb_cdc_pret(void) {
+    return usb_configuration && usb_dtr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  usb_cdc_ecrire
+//  Valeur de retour :  char  =>  1 si les octets sont rangs, 0 si la
+//                                place manque ou si le port est ferm
+//  Paramtres       :  const unsigned char *donnees
+//                      unsigned char nb
+//                        nombre d'octets, USB_CDC_EMISSION au plus
+//  Description      :  range le bloc entier ou rien, sans attendre ;
+//                      utilisable dans le programme principal comme dans
+//                      une routine d'interruption
+///////////////////////////////////////////////////////////////////////////////
+
+char usb_cdc_ecrire(const unsigned char *donnees, unsigned char nb) {
+    unsigned char t, i;
+    unsigned char gieh;
+
+    if (!usb_cdc_pret()) return 0;
+
+    // Deux producteurs possibles : la routine haute est masque (GIEH
+    // vaut dj 0 dans la routine haute)
+    gieh = INTCONbits.GIEH;
+    INTCONbits.GIEH = 0;
+    t = usb_emission_tete;
+    if (USB_CDC_EMISSION - (unsigned char) (t - usb_emission_queue) < nb) {
+        INTCONbits.GIEH = gieh;
+        return 0;
+    }
+    for (i = 0; i < nb; i++) {
+        usb_emission[t++ & (USB_CDC_EMISSION - 1)] = donnees[i];
+    }
+    usb_emission_tete = t;  // bloc publi d'un coup
+    INTCONbits.GIEH = gieh;
+    return 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  usb_cdc_place
+//  Valeur de retour :  unsigned char  =>  octets libres dans le tampon
+//                                         d'mission
+//  Paramtres       :  aucun
+//  Description      :  pour attendre de la place avant usb_cdc_ecrire
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned char usb_cdc_place(void) {
+    return USB_CDC_EMISSION
+            - (unsigned char) (usb_emission_tete - usb_emission_queue);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  usb_cdc_lire
+//  Valeur de retour :  unsigned char  =>  nombre d'octets copis
+//  Paramtres       :  unsigned char *donnees
+//                      unsigned char max
+//                        taille de donnees
+//  Description      :  copie les octets reus, dans l'ordre, sans
+//                      attendre ; un seul lecteur (programme principal)
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned char usb_cdc_lire(unsigned char *donnees, unsigned char max) {
+    unsigned char q = usb_reception_queue;
+    unsigned char n = 0;
+
+    while (n < max && q != usb_reception_tete) {
+        donnees[n++] = usb_reception[q++ & (USB_CDC_RECEPTION - 1)];
+    }
+    usb_reception_queue = q;
+    return n;
+}
@@ -0,0 +1,121 @@
+#ifndef __IUT_USB_CDC_H
+#define __IUT_USB_CDC_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Port srie virtuel sur l'USB (classe CDC-ACM, full speed)
+//
+// IUT de Cachan
+// Version 10/2026 pour xc8
+//
+// Le PIC est vu par le PC comme un port srie (/dev/ttyACM0, COMx) : pas
+// de pilote  installer, le dbit annonc par le PC est ignor. Pile
+// minimale : numration sur l'endpoint 0, endpoint 1 d'interruption
+// dclar mais jamais utilis, endpoint 2 bulk de 64 octets dans les deux
+// sens. Tout est trait dans l'interruption USB, en priorit basse.
+//
+// Emission : usb_cdc_ecrire range les octets dans un tampon circulaire de
+// USB_CDC_EMISSION octets ; l'interruption en remplit l'endpoint 2 
+// chaque trame USB (1 ms) et  chaque paquet parti, soit 64 octets par ms
+// au moins. Le programme principal et la routine haute peuvent crire :
+// la routine haute est masque pendant la copie (1 us par octet environ).
+// Rception : les paquets reus sont copis dans un tampon de
+// USB_CDC_RECEPTION octets, lu par usb_cdc_lire. Tampon plein, le paquet
+// attend dans l'endpoint et le PC est mis en attente (NAK) : rien n'est
+// perdu.
+//
+// Rien n'est mis tant que le PC n'a pas ouvert le port (signal DTR).
+//
+// Fonctions disponibles
+//
+//   void usb_cdc_init(void);
+//     Connecte le PIC au bus, enregistre l'interruption USB en priorit
+//     basse ;  appeler aprs it_init et avant it_autoriser
+//
+//   char usb_cdc_pret(void);
+//     1 si le port est ouvert ct PC
+//
+//   char usb_cdc_ecrire(const unsigned char *donnees, unsigned char nb);
+//     Range nb octets d'un bloc, ou aucun si la place manque
+//
+//   unsigned char usb_cdc_place(void);
+//     Place libre dans le tampon d'mission
+//
+//   unsigned char usb_cdc_lire(unsigned char *donnees, unsigned char max);
+//     Copie jusqu' max octets reus, renvoie le nombre copi
+//
+//   Broche - Signal
+//     D-   -   RC4
+//     D+   -   RC5
+//     VUSB -   RC3 (condensateur de 220 nF  470 nF)
+//
+// L'horloge USB (PLL  96 MHz, USBDIV = 2) et le rgulateur (VREGEN) sont
+// configurs par iut_init.c.
+//
+// Pour plus d'informations, consultez p18f4550_39632e.pdf 17
+///////////////////////////////////////////////////////////////////////////////
+
+#include <xc.h>
+
+// Tailles des tampons : puissances de 2, 128 au plus ; la rception
+// contient au moins un paquet de 64 octets
+#define USB_CDC_EMISSION    128     // octets
+#define USB_CDC_RECEPTION   64      // octets
+
+// Identifiants USB : VID de Microchip, PID de sa note CDC
+#define USB_CDC_VID     0x04D8
+#define USB_CDC_PID     0x000A
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  usb_cdc_init
+//  Valeur de retour :  aucune
+//  Paramtres       :  aucun
+//  Description      :  configure le module USB (full speed, rsistance de
+//                      tirage interne), enregistre l'interruption en
+//                      priorit basse et connecte le PIC au bus ;
+//                      l'numration se fait ensuite sous interruption
+///////////////////////////////////////////////////////////////////////////////
+void usb_cdc_init(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  usb_cdc_pret
+//  Valeur de retour :  char  =>  1 si le PIC est configur et le port
+//                                ouvert ct PC (DTR), 0 sinon
+//  Paramtres       :  aucun
+//  Description      :  tat de la liaison
+///////////////////////////////////////////////////////////////////////////////
+char usb_cdc_pret(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  usb_cdc_ecrire
+//  Valeur de retour :  char  =>  1 si les octets sont rangs, 0 si la
+//                                place manque ou si le port est ferm
+//  Paramtres       :  const unsigned char *donnees
+//                      unsigned char nb
+//                        nombre d'octets, USB_CDC_EMISSION au plus
+//  Description      :  range le bloc entier ou rien, sans attendre ;
+//                      utilisable dans le programme principal comme dans
+//                      une routine d'interruption
+///////////////////////////////////////////////////////////////////////////////
+char usb_cdc_ecrire(const unsigned char *donnees, unsigned char nb);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  usb_cdc_place
+//  Valeur de retour :  unsigned char  =>  octets libres dans le tampon
+//                                         d'mission
+//  Paramtres       :  aucun
+//  Description      :  pour attendre de la place avant usb_cdc_ecrire
+///////////////////////////////////////////////////////////////////////////////
+unsigned char usb_cdc_place(void);
+
+///////////////////////////////////////////////////////////////////////////////
+//  Nom de fonction  :  usb_cdc_lire
+//  Valeur de retour :  unsigned char  =>  nombre d'octets copis
+//  Paramtres       :  unsigned char *donnees
+//                      unsigned char max
+//                        taille de donnees
+//  Description      :  copie les octets reus, dans l'ordre, sans
+//                      attendre ; un seul lecteur (programme principal)
+///////////////////////////////////////////////////////////////////////////////
+unsigned char usb_cdc_lire(unsigned char *donnees, unsigned char max);
+
+#endif
@@ -0,0 +1,199 @@
+#include <xc.h>
+#include "iut_eeprom.h"
+#include "iut_taches.h"
+#include "iut_uart.h"
+#include "boite.h"
+
+#define BOITE_MARQUE    0xB017      // état en RAM valable
+
+// Etat du suivi d'un échantillon absent : fin d'un bloc interrompu
+#define BOITE_FIN_BLOC  7
+
+// Etats
+#define BOITE_LIBRE     0   // rien à garder
+#define BOITE_ACTIVE    1   // course en cours, enregistrement
+#define BOITE_FIGEE     2   // à copier en EEPROM
+
+// Conservés par un reset (pas effacés au démarrage)
+static persistent unsigned int marque;
+static persistent unsigned char etat;
+static persistent unsigned char entete[BOITE_ENTETE];
+static persistent unsigned char blocs[BOITE_BLOCS][BOITE_BLOC];
+static persistent unsigned char bloc, rang, nbBlocs;
+static persistent unsigned int dernierTic;
+
+static int reconstruite;    // position décodée du dernier échantillon
+
+void boite_init(void) {
+    if (!RCONbits.nPOR || marque != BOITE_MARQUE) {
+        // mise sous tension : le contenu de la RAM est quelconque
+        marque = BOITE_MARQUE;
+        etat = BOITE_LIBRE;
+    } else if (etat == BOITE_ACTIVE) {
+        boite_figer(BOITE_RESET, dernierTic);
+    }
+    // BOITE_FIGEE : la copie reprend depuis le début
+}
+
+void boite_depart(void) {
+    if (etat == BOITE_FIGEE) return;
+    bloc = 0;
+    rang = 0;
+    nbBlocs = 0;
+    etat = BOITE_ACTIVE;
+}
+
+// Bloc suivant : le plus ancien ne sera écrasé qu'au premier échantillon
+static void blocSuivant(void) {
+    rang = 0;
+    if (++bloc == BOITE_BLOCS) bloc = 0;
+}
+
+void boite_echantillon(unsigned int tic, int position, unsigned char suivi,
+        char fond, int differentiel) {
+    unsigned char *b;
+    int ecart;
+
+    if (etat != BOITE_ACTIVE) return;
+    b = blocs[bloc];
+    if (rang == 0) {
+        if (nbBlocs < BOITE_BLOCS) nbBlocs++;
+        b[0] = (unsigned char) tic;
+        b[1] = (unsigned char) (tic >> 8);
+        b[2] = (unsigned char) position;
+        b[3] = (unsigned char) ((unsigned int) position >> 8);
+        reconstruite = position;
+    }
+    ecart = position - reconstruite;
+    if (ecart > 127) ecart = 127;
+    if (ecart < -127) ecart = -127;
+    reconstruite += ecart;
+    differentiel >>= 9;     // / 512, arrondi vers -infini
+    if (differentiel > 7) differentiel = 7;
+    if (differentiel < -8) differentiel = -8;
+    b[4 + 2 * rang] = (unsigned char) ecart;
+    b[5 + 2 * rang] = (unsigned char) ((suivi << 5) | (fond ? 0x10 : 0)
+            | (differentiel & 0x0F));
+    dernierTic = tic;
+
+    if (++rang == BOITE_ECHANTILLONS) blocSuivant();
+}
+
+void boite_interrompre(void) {
+    if (etat != BOITE_ACTIVE || rang == 0) return;
+    // échantillons restants du bloc marqués absents : le premier suffit
+    blocs[bloc][5 + 2 * rang] = BOITE_FIN_BLOC << 5;
+    blocSuivant();
+}
+
+void boite_figer(unsigned char cause, unsigned int tic) {
+    if (etat != BOITE_ACTIVE) return;
+    // bloc en cours vide : le plus récent est le précédent, le bloc vide
+    // garde le plus ancien intact
+    if (rang == 0 && nbBlocs) {
+        bloc = (bloc == 0) ? BOITE_BLOCS - 1 : bloc - 1;
+        rang = BOITE_ECHANTILLONS;
+    }
+    entete[0] = BOITE_VERSION;
+    entete[1] = cause;
+    entete[2] = bloc;
+    entete[3] = rang;
+    entete[4] = nbBlocs;
+    entete[5] = (unsigned char) tic;
+    entete[6] = (unsigned char) (tic >> 8);
+    etat = BOITE_FIGEE;
+}
+
+// Blocs puis entête : l'entête et son CRC ne sont écrits qu'une fois les
+// blocs en place
+char boite_ecrire(struct pt *pt) {
+    static unsigned char n, crc;
+
+    PT_DEBUT(pt);
+    if (etat == BOITE_FIGEE) {
+        crc = 0;
+        for (n = 0; n < BOITE_ENTETE - 1; n++) {
+            crc = eeprom_crc8(crc, entete[n]);
+        }
+        for (n = 0; n < BOITE_BLOCS * BOITE_BLOC; n++) {
+            PT_ATTENDRE_QUE(pt, !eeprom_occupee());
+            eeprom_ecrire(BOITE_ADRESSE + BOITE_ENTETE + n, blocs[0][n]);
+            crc = eeprom_crc8(crc, blocs[0][n]);
+        }
+        entete[BOITE_ENTETE - 1] = crc;
+        for (n = 0; n < BOITE_ENTETE; n++) {
+            PT_ATTENDRE_QUE(pt, !eeprom_occupee());
+            eeprom_ecrire(BOITE_ADRESSE + n, entete[n]);
+        }
+        etat = BOITE_LIBRE;
+    }
+    PT_FIN(pt);
+}
+
+static unsigned char lire(unsigned char n) {
+    return eeprom_lire(BOITE_ADRESSE + n);
+}
+
+void boite_envoyer(void) {
+    unsigned char n, b, r, nb, octet;
+    unsigned char crc = 0;
+    unsigned int tic;
+    int position, d;
+
+    if (etat == BOITE_FIGEE) {
+        uart_puts("boite;copie en cours\r\n");
+        return;
+    }
+    for (n = 0; n < BOITE_ENTETE - 1; n++) crc = eeprom_crc8(crc, lire(n));
+    for (n = 0; n < BOITE_BLOCS * BOITE_BLOC; n++) {
+        crc = eeprom_crc8(crc, lire(BOITE_ENTETE + n));
+    }
+    if (lire(0) != BOITE_VERSION || lire(BOITE_ENTETE - 1) != crc) {
+        uart_puts("boite;vide\r\n");
+        return;
+    }
+    uart_puts("boite;");
+    uart_putu(lire(1));
+    uart_putc(';');
+    uart_putu(lire(5) | ((unsigned int) lire(6) << 8));
+    uart_puts("\r\n");
+
+    // du bloc le plus ancien au plus récent
+    nb = lire(4);
+    b = lire(2) + BOITE_BLOCS + 1 - nb;
+    while (nb--) {
+        b %= BOITE_BLOCS;
+        n = BOITE_ENTETE + b * BOITE_BLOC;
+        tic = lire(n) | ((unsigned int) lire(n + 1) << 8);
+        position = (int) (lire(n + 2) | ((unsigned int) lire(n + 3) << 8));
+        r = nb ? BOITE_ECHANTILLONS : lire(3);
+        for (n += 4; r--; n += 2) {
+            octet = lire(n + 1);
+            if (octet >> 5 == BOITE_FIN_BLOC) break;
+            position += (signed char) lire(n);
+            d = (octet & 0x08) ? (int) (octet & 0x0F) - 16 : octet & 0x0F;
+            uart_putu(tic);
+            uart_putc(';');
+            if (position < 0) {
+                uart_putc('-');
+                uart_putu((unsigned int) -position);
+            } else {
+                uart_putu(position);
+            }
+            uart_putc(';');
+            uart_putu(octet >> 5);
+            uart_putc(';');
+            uart_putu((octet >> 4) & 1);
+            uart_putc(';');
+            if (d < 0) {
+                uart_putc('-');
+                uart_putu((unsigned int) -d * 512);
+            } else {
+                uart_putu((unsigned int) d * 512);
+            }
+            uart_puts("\r\n");
+            tic += BOITE_PAS;
+        }
+        b++;
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef BOITE_H
+#define BOITE_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Boîte noire : les derniers instants de la course, gardés en EEPROM
+//
+// Pendant la course, chaque boucle externe (tous les ASSERV_DIVISEUR
+// tics, quand la direction décide) ajoute un échantillon de 2 octets à
+// un tampon circulaire de BOITE_BLOCS blocs en RAM :
+//   - octet 0 : écart de la position à la position reconstruite de
+//     l'échantillon précédent, borné à +/- 127 (l'écart suivant rattrape
+//     l'erreur, sans dérive) ;
+//   - octet 1 : état du suivi (bits 5-7, 7 réservé : fin d'un bloc
+//     interrompu), ligne non vue (bit 4), consigne droite - gauche / 512
+//     bornée à -8..7 (bits 0-3).
+// Chaque bloc commence par une clé de 4 octets (tic de la course, position
+// absolue) : l'écrasement du bloc le plus ancien ne gêne pas le décodage
+// des autres. 6 blocs de 8 échantillons : 160 à 190 ms.
+// Coût par boucle externe fixe : quelques affectations, sans boucle.
+//
+// Pendant la recherche de la ligne perdue (jusqu'à 0,5 s, plus que le
+// tampon), l'enregistrement est interrompu par boite_interrompre : sur un
+// arrêt pour ligne perdue, la boîte garde les instants où le robot a
+// quitté la ligne, pas la fin de la recherche. Ligne retrouvée,
+// l'enregistrement reprend dans un nouveau bloc.
+//
+// Arrêt de la course (ligne perdue, JCK, défaut de la commande) : le
+// tampon est figé, puis boite_ecrire (tâche de fond) le recopie octet par
+// octet dans la zone 0x80 - 0xFF de l'EEPROM (parametres.h), sans
+// attendre la fin de chaque écriture (environ 0,5 s en tout). L'entête,
+// écrit en dernier, porte un CRC-8 de toute la zone : une copie
+// interrompue est reconnue.
+//
+// Le tampon et son état sont conservés par un reset (persistent) : un
+// reset du chien de garde pendant la course fige le tampon au
+// redémarrage, avec la cause BOITE_RESET ; une copie interrompue par un
+// reset reprend.
+//
+// EEPROM :
+//   0x80  BOITE_VERSION
+//   0x81  cause
+//   0x82  bloc le plus récent
+//   0x83  échantillons dans ce bloc
+//   0x84  blocs écrits (BOITE_BLOCS au plus)
+//   0x85  tic de l'arrêt (16 bits, poids faible en premier)
+//   0x87  CRC-8 des octets 0x80 - 0x86 puis des blocs
+//   0x88  blocs de BOITE_BLOC octets
+///////////////////////////////////////////////////////////////////////////////
+
+#include "iut_taches.h"
+#include "asservissement.h"
+
+#define BOITE_ADRESSE   0x80
+#define BOITE_VERSION   1
+#define BOITE_ENTETE    8
+#define BOITE_ECHANTILLONS  8   // par bloc
+#define BOITE_BLOC      (4 + 2 * BOITE_ECHANTILLONS)
+#define BOITE_BLOCS     6
+#define BOITE_PAS       ASSERV_DIVISEUR     // tics entre deux échantillons
+
+// Causes
+#define BOITE_AUCUNE    0
+#define BOITE_PERDUE    1   // ligne perdue
+#define BOITE_JCK       2
+#define BOITE_DEFAUT    3   // défaut de la commande (surveillance.h)
+#define BOITE_RESET     4   // reset pendant la course
+
+// Au démarrage, avant surveillance_init (qui réarme nPOR) : reprend un
+// tampon figé ou une course coupée par un reset
+void boite_init(void);
+
+// Au départ de la course (priorité haute) : tampon vidé, enregistrement ;
+// sans effet pendant la copie d'une course précédente
+void boite_depart(void);
+
+// A chaque boucle externe de la course, priorité haute
+// tic : tics depuis le départ ; fond : CD et CG sous le seuil
+void boite_echantillon(unsigned int tic, int position, unsigned char suivi,
+        char fond, int differentiel);
+
+// A chaque boucle externe sans échantillon (recherche de la ligne),
+// priorité haute : le bloc en cours est fermé, le prochain échantillon
+// ouvre un nouveau bloc
+void boite_interrompre(void);
+
+// A l'arrêt de la course, priorité haute : tampon figé pour la copie
+void boite_figer(unsigned char cause, unsigned int tic);
+
+// Tâche de fond : copie du tampon figé en EEPROM, un octet par écriture
+// terminée ; rend la main tout de suite s'il n'y a rien à copier
+char boite_ecrire(struct pt *pt);
+
+// Décode la boîte en EEPROM sur la liaison série, une ligne par
+// échantillon, du plus ancien au plus récent (position reconstruite,
+// consigne droite - gauche à 512 fronts/s près) :
+//   boite;cause;tic_arret
+//   tic;position;etat;fond;differentiel
+void boite_envoyer(void);
+
+#endif
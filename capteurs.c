@@ -0,0 +1,27 @@
+#include <xc.h>
+#include "capteurs.h"
+
+static volatile unsigned char numero;   // impair pendant l'écriture
+static volatile struct capteurs derniers;
+
+void capteurs_publier(unsigned long date, int potent, int cg, int cd) {
+    numero++;
+    derniers.date = date;
+    derniers.potent = potent;
+    derniers.cg = cg;
+    derniers.cd = cd;
+    derniers.position = cd - cg;
+    numero++;
+}
+
+void capteurs_lire(struct capteurs *c) {
+    unsigned char n;
+
+    // numéro lu en un accès (8 bits) ; copie à refaire si la commande a
+    // publié pendant ce temps
+    do {
+        n = numero;
+        *c = derniers;
+    } while ((n & 1) || n != numero);
+    c->numero = n;
+}
@@ -0,0 +1,37 @@
+#ifndef CAPTEURS_H
+#define CAPTEURS_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Instantané cohérent des capteurs
+//
+// La commande (fin du scan ADC, priorité haute) publie à chaque tic le
+// potentiomètre, CG, CD et la position, datés et numérotés. Les lecteurs
+// de priorité plus basse (tâches de fond, priorité basse) en font une
+// copie sans masquer les interruptions, à la manière d'un seqlock :
+//   - l'écrivain rend le numéro impair avant d'écrire, pair après ;
+//   - le lecteur recopie entre deux lectures du numéro et recommence si
+//     le numéro était impair ou a changé entre les deux.
+// Une copie ne mélange donc jamais deux tics. L'écrivain n'attend jamais ;
+// le lecteur recommence au plus une fois par tic (copie de 13 octets,
+// quelques us contre 1 ms entre deux publications).
+//
+// Le numéro avance de 2 par tic : deux lectures de même numéro ont lu le
+// même tic. La date est celle de la commande, à durée fixe de la
+// conversion de CD après le lancement du scan.
+///////////////////////////////////////////////////////////////////////////////
+
+struct capteurs {
+    unsigned char numero;   // pair, +2 par publication
+    unsigned long date;     // pas de 0,667 us (iut_temps.h)
+    int potent;
+    int cg, cd;
+    int position;           // cd - cg
+};
+
+// Depuis la commande, priorité haute seulement
+void capteurs_publier(unsigned long date, int potent, int cg, int cd);
+
+// Copie de la dernière publication, hors priorité haute
+void capteurs_lire(struct capteurs *c);
+
+#endif
@@ -0,0 +1,157 @@
+#include <xc.h>
+#include "iut_codeurs.h"
+#include "iut_uart.h"
+#include "carte.h"
+
+static struct segment segments[CARTE_MAX];
+static unsigned char nbSegments = 0;
+static char carteValide = 0;        // apprise, utilisée aux tours suivants
+
+static char apprentissage;
+static unsigned long origine;       // distance au départ ou à la marque
+static unsigned char courant;       // segment en cours
+
+// Apprentissage : fenêtre en cours
+static unsigned long finFenetre;
+static int sommeVirage;
+static unsigned int ticsFenetre;
+
+// Tour suivant : fin du segment courant en fronts depuis l'origine
+static unsigned long finSegment;
+static unsigned int facteur = 256;
+
+static unsigned long distance(void) {
+    return (codeurs_nombre(CODEUR_DROIT) + codeurs_nombre(CODEUR_GAUCHE)) / 2;
+}
+
+static unsigned char type(signed char courbure) {
+    if (courbure >= CARTE_SEUIL_VIRAGE) return SEGMENT_DROITE;
+    if (courbure <= -CARTE_SEUIL_VIRAGE) return SEGMENT_GAUCHE;
+    return SEGMENT_DROIT;
+}
+
+void carte_init(void) {
+    nbSegments = 0;
+    carteValide = 0;
+    facteur = 256;
+}
+
+// Position au début de la carte
+static void recaler(void) {
+    origine = distance();
+    courant = 0;
+    facteur = 256;
+    finSegment = segments[0].longueur;
+}
+
+void carte_depart(void) {
+    apprentissage = !carteValide;
+    if (apprentissage) {
+        origine = distance();
+        facteur = 256;
+        nbSegments = 0;
+        finFenetre = origine + CARTE_FENETRE;
+        sommeVirage = 0;
+        ticsFenetre = 0;
+    } else {
+        recaler();
+    }
+}
+
+// Fenêtre terminée : allonge le segment en cours ou en ouvre un nouveau
+static void fermerFenetre(void) {
+    signed char c;
+    struct segment *s;
+
+    if (ticsFenetre == 0) return;
+    c = (signed char) ((long) sommeVirage * 100 / (long) ticsFenetre);
+    if (nbSegments && (type(c) == type(segments[nbSegments - 1].courbure)
+            || nbSegments == CARTE_MAX)) {
+        s = &segments[nbSegments - 1];
+        // courbure moyenne pondérée par la longueur
+        s->courbure = (signed char) (((long) s->courbure * s->longueur
+                + (long) c * CARTE_FENETRE) / (s->longueur + CARTE_FENETRE));
+        s->longueur += CARTE_FENETRE;
+        s->duree += ticsFenetre;
+    } else {
+        s = &segments[nbSegments++];
+        s->longueur = CARTE_FENETRE;
+        s->courbure = c;
+        s->duree = ticsFenetre;
+    }
+    sommeVirage = 0;
+    ticsFenetre = 0;
+}
+
+void carte_tic(signed char virage) {
+    unsigned long d = distance();
+    struct segment *s;
+
+    if (apprentissage) {
+        sommeVirage += virage;
+        ticsFenetre++;
+        if ((long) (d - finFenetre) >= 0) {
+            fermerFenetre();
+            finFenetre += CARTE_FENETRE;
+        }
+        return;
+    }
+
+    // position sur la carte
+    d -= origine;
+    while (d >= finSegment && courant < nbSegments - 1) {
+        courant++;
+        finSegment += segments[courant].longueur;
+    }
+    s = &segments[courant];
+    if (d >= finSegment) {
+        facteur = 256;      // au-delà de la carte : rien de connu
+    } else if (type(s->courbure) != SEGMENT_DROIT) {
+        facteur = 256;
+    } else if (courant < nbSegments - 1 && d + CARTE_FREINAGE >= finSegment) {
+        facteur = 256;      // virage à l'approche : on freine
+    } else {
+        facteur = CARTE_FACTEUR_DROIT;
+    }
+}
+
+void carte_ligne(void) {
+    if (apprentissage) {
+        fermerFenetre();
+        if (nbSegments == 0) return;    // marque dès le départ
+        apprentissage = 0;
+        carteValide = 1;
+    }
+    recaler();
+}
+
+void carte_fin(char complete) {
+    if (!apprentissage) return;
+    apprentissage = 0;
+    if (!complete) return;  // carte partielle : nouvel apprentissage
+    fermerFenetre();
+    carteValide = (nbSegments != 0);
+}
+
+unsigned int carte_facteur(void) {
+    return facteur;
+}
+
+void carte_envoyer(void) {
+    unsigned char i;
+
+    for (i = 0; i < nbSegments; i++) {
+        uart_puts("segment;");
+        uart_putu(segments[i].longueur);
+        uart_putc(';');
+        if (segments[i].courbure < 0) {
+            uart_putc('-');
+            uart_putu(-segments[i].courbure);
+        } else {
+            uart_putu(segments[i].courbure);
+        }
+        uart_putc(';');
+        uart_putu(segments[i].duree);
+        uart_puts("\r\n");
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef CARTE_H
+#define CARTE_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Carte de la piste et profil de vitesse
+//
+// Premier tour après la mise sous tension : apprentissage, du départ à la
+// première marque de départ et d'arrivée (CHRONO_LIGNE, chrono.h), ou à la
+// fin de la course sur une piste sans marque. La distance
+// parcourue (moyenne des deux codeurs) est découpée en fenêtres de
+// CARTE_FENETRE fronts. Pour chaque fenêtre, la courbure est la part du
+// temps passé à tourner (+100 : toujours à droite, -100 : toujours à
+// gauche). Une fenêtre de même type que le segment en cours (ligne
+// droite, virage à droite, virage à gauche) l'allonge, sinon elle ouvre
+// un nouveau segment.
+//
+// Une course abandonnée (ligne perdue, défaut) ou arrêtée avant la
+// première marque d'une piste marquée ne valide pas la carte.
+//
+// Tours suivants : la position sur la carte est la distance parcourue
+// depuis la dernière marque, ou depuis le départ avant la première. Sur
+// une ligne droite, les consignes de vitesse sont
+// multipliées par CARTE_FACTEUR_DROIT, sauf dans les CARTE_FREINAGE
+// derniers fronts avant un virage connu : on revient alors à la vitesse
+// de l'apprentissage pour aborder le virage. Au-delà de la fin de la
+// carte, les consignes ne sont plus modifiées.
+//
+// La position est recalée au départ et à chaque marque : le départ se
+// fait juste avant la marque, sinon le premier tour, plus court, fausse la
+// carte. 5 octets par segment en RAM, la carte est perdue à la mise hors
+// tension.
+///////////////////////////////////////////////////////////////////////////////
+
+#define CARTE_MAX           48      // segments
+#define CARTE_FENETRE       100     // fronts de codeur par fenêtre
+#define CARTE_SEUIL_VIRAGE  30      // % du temps en virage
+#define CARTE_FACTEUR_DROIT 333     // x 256 : +30 % en ligne droite
+#define CARTE_FREINAGE      300     // fronts avant un virage
+
+// Types de segment
+#define SEGMENT_DROIT       0
+#define SEGMENT_DROITE      1
+#define SEGMENT_GAUCHE      2
+
+struct segment {
+    unsigned int longueur;  // fronts de codeur
+    signed char courbure;   // -100 (gauche) à +100 (droite)
+    unsigned int duree;     // tics (ms) pour le parcourir à l'apprentissage
+};
+
+// Efface la carte : le prochain tour sera un apprentissage
+void carte_init(void);
+
+// Au départ de la course (priorité haute ou interruptions masquées)
+void carte_depart(void);
+
+// A chaque tic de course, priorité haute
+// virage : +1 tourne à droite, -1 à gauche, 0 tout droit
+void carte_tic(signed char virage);
+
+// Marque de départ et d'arrivée passée, priorité haute : ferme
+// l'apprentissage, puis recale la position au début de la carte
+void carte_ligne(void);
+
+// A la fin de la course : ferme l'apprentissage s'il est encore en cours.
+// complete : course entière valable pour un tour (piste sans marque,
+// arrêt par JCK) ; sinon la carte partielle est oubliée, la course
+// suivante reprend l'apprentissage
+void carte_fin(char complete);
+
+// Facteur de vitesse à appliquer aux consignes, x 256
+unsigned int carte_facteur(void);
+
+// Envoie la carte sur la liaison série : segment;longueur;courbure;duree
+void carte_envoyer(void);
+
+#endif
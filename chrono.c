@@ -0,0 +1,188 @@
+#include <xc.h>
+#include "iut_temps.h"
+#include "iut_eeprom.h"
+#include "iut_uart.h"
+#include "chrono.h"
+
+struct chrono_record chronoRecord;
+static unsigned char numero;        // de l'emplacement le plus récent
+static unsigned char place;
+
+static struct chrono_tour tours[CHRONO_TOURS];
+static unsigned char nbTours;       // tours terminés
+static char tourOuvert;
+static unsigned long debutTour;     // date, base de temps
+static unsigned char nbInter;
+static char repereVu;       // piste marquée : pas de tour sur la course entière
+
+// Pas de la base de temps (2/3 us) en us, sans débordement
+static unsigned long microsecondes(unsigned long pas) {
+    return pas / 3 * 2 + (pas % 3) * 2 / 3;
+}
+
+// Octets du record dans l'ordre de l'EEPROM, poids faible en premier
+static void coder(unsigned char *o) {
+    unsigned char n;
+
+    for (n = 0; n < 4; n++) {
+        o[n] = (unsigned char) (chronoRecord.meilleur >> (8 * n));
+        o[4 + n] = (unsigned char) (chronoRecord.dernier >> (8 * n));
+        o[10 + n] = (unsigned char) (chronoRecord.somme >> (8 * n));
+    }
+    o[8] = (unsigned char) chronoRecord.nombre;
+    o[9] = (unsigned char) (chronoRecord.nombre >> 8);
+}
+
+static void decoder(const unsigned char *o) {
+    unsigned char n;
+
+    chronoRecord.meilleur = 0;
+    chronoRecord.dernier = 0;
+    chronoRecord.somme = 0;
+    for (n = 4; n-- > 0;) {
+        chronoRecord.meilleur = (chronoRecord.meilleur << 8) | o[n];
+        chronoRecord.dernier = (chronoRecord.dernier << 8) | o[4 + n];
+        chronoRecord.somme = (chronoRecord.somme << 8) | o[10 + n];
+    }
+    chronoRecord.nombre = ((unsigned int) o[9] << 8) | o[8];
+}
+
+// Emplacement : numéro, 14 octets du record, CRC du numéro et du record
+void chrono_charger(void) {
+    unsigned char p, n, adresse, crc, num;
+    unsigned char o[CHRONO_TAILLE - 2], meilleur[CHRONO_TAILLE - 2];
+    char trouve = 0;
+
+    for (p = 0; p < CHRONO_PLACES; p++) {
+        adresse = CHRONO_ADRESSE + p * CHRONO_TAILLE;
+        num = eeprom_lire(adresse);
+        crc = eeprom_crc8(0, num);
+        for (n = 0; n < CHRONO_TAILLE - 2; n++) {
+            o[n] = eeprom_lire(adresse + 1 + n);
+            crc = eeprom_crc8(crc, o[n]);
+        }
+        if (eeprom_lire(adresse + CHRONO_TAILLE - 1) != crc) continue;
+        // plus récent : numéro en avance, modulo 256
+        if (!trouve || (signed char) (num - numero) > 0) {
+            trouve = 1;
+            numero = num;
+            place = p;
+            for (n = 0; n < CHRONO_TAILLE - 2; n++) meilleur[n] = o[n];
+        }
+    }
+    if (trouve) {
+        decoder(meilleur);
+    } else {
+        numero = 0;
+        place = CHRONO_PLACES - 1;  // première écriture en 0
+        chronoRecord.meilleur = 0;
+        chronoRecord.dernier = 0;
+        chronoRecord.nombre = 0;
+        chronoRecord.somme = 0;
+    }
+}
+
+static void sauver(void) {
+    unsigned char n, adresse, crc;
+    unsigned char o[CHRONO_TAILLE - 2];
+
+    if (++place == CHRONO_PLACES) place = 0;
+    numero++;
+    adresse = CHRONO_ADRESSE + place * CHRONO_TAILLE;
+    coder(o);
+    eeprom_ecrire(adresse, numero);
+    crc = eeprom_crc8(0, numero);
+    for (n = 0; n < CHRONO_TAILLE - 2; n++) {
+        eeprom_ecrire(adresse + 1 + n, o[n]);
+        crc = eeprom_crc8(crc, o[n]);
+    }
+    eeprom_ecrire(adresse + CHRONO_TAILLE - 1, crc);
+}
+
+void chrono_depart(unsigned long date) {
+    nbTours = 0;
+    tourOuvert = 0;
+    repereVu = 0;
+    debutTour = date;
+}
+
+static void ouvrirTour(unsigned long date) {
+    unsigned char n;
+
+    tourOuvert = 1;
+    debutTour = date;
+    nbInter = 0;
+    if (nbTours < CHRONO_TOURS) {
+        for (n = 0; n < CHRONO_INTER; n++) tours[nbTours].inter[n] = 0;
+    }
+}
+
+// Tour terminé : gardé pour le rapport, ajouté au record
+static void fermerTour(unsigned long duree) {
+    if (nbTours < CHRONO_TOURS) tours[nbTours].duree = duree;
+    nbTours++;
+    chronoRecord.dernier = duree;
+    if (chronoRecord.meilleur == 0 || duree < chronoRecord.meilleur) {
+        chronoRecord.meilleur = duree;
+    }
+    chronoRecord.nombre++;
+    chronoRecord.somme += (duree + 500) / 1000;
+}
+
+void chrono_repere(const struct repere *r) {
+    if (r->type != REPERE_TROU) repereVu = 1;
+    if (r->type == CHRONO_LIGNE) {
+        if (tourOuvert) fermerTour(microsecondes(r->date - debutTour));
+        ouvrirTour(r->date);
+    } else if (tourOuvert && r->type != REPERE_TROU) {
+        if (nbInter < CHRONO_INTER && nbTours < CHRONO_TOURS) {
+            tours[nbTours].inter[nbInter] = microsecondes(r->date - debutTour);
+        }
+        nbInter++;
+    }
+}
+
+void chrono_fin(unsigned long duree, char normal) {
+    unsigned char n;
+
+    // piste sans repère, arrêt normal : la course entière fait un tour
+    if (normal && !repereVu && nbTours == 0) {
+        for (n = 0; n < CHRONO_INTER; n++) tours[0].inter[n] = 0;
+        fermerTour(microsecondes(duree));
+    }
+    tourOuvert = 0;
+    if (nbTours) sauver();
+}
+
+unsigned char chrono_nombre(void) {
+    return nbTours;
+}
+
+unsigned long chrono_moyenne(void) {
+    return chronoRecord.nombre ? chronoRecord.somme / chronoRecord.nombre : 0;
+}
+
+void chrono_envoyer(void) {
+    unsigned char t, n;
+
+    for (t = 0; t < nbTours && t < CHRONO_TOURS; t++) {
+        uart_puts("tour;");
+        uart_putu(t + 1);
+        uart_putc(';');
+        uart_putu(tours[t].duree);
+        for (n = 0; n < CHRONO_INTER; n++) {
+            uart_putc(';');
+            uart_putu(tours[t].inter[n]);
+        }
+        uart_puts("\r\n");
+    }
+    uart_puts("record;");
+    uart_putu(chronoRecord.meilleur);
+    uart_putc(';');
+    uart_putu(chronoRecord.dernier);
+    uart_putc(';');
+    uart_putu(chrono_moyenne());
+    uart_putc(';');
+    uart_putu(chronoRecord.nombre);
+    uart_puts("\r\n");
+}
@@ -0,0 +1,80 @@
+#ifndef CHRONO_H
+#define CHRONO_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Chronométrage des tours et record en EEPROM
+//
+// Les dates viennent de la base de temps du Timer1 (iut_temps.h, pas de
+// 0,667 us) ; les durées sont rendues en microsecondes.
+//
+// Tours : la marque de départ et d'arrivée (CHRONO_LIGNE, reperes.h)
+// ouvre le premier tour lancé, puis chaque passage ferme un tour et ouvre
+// le suivant. Les autres repères (croisements, marques de l'autre côté)
+// donnent les temps intermédiaires du tour, CHRONO_INTER au plus. Piste
+// sans aucun repère (les trous exceptés) : la course entière, du front de
+// FDC à l'arrêt par JCK, compte pour un tour. Une course abandonnée
+// (ligne perdue, défaut) ou arrêtée avant la première marque d'une piste
+// marquée ne garde que ses tours fermés entre deux marques. Les
+// CHRONO_TOURS premiers tours de la course sont gardés en RAM pour le
+// rapport.
+//
+// Record (meilleur tour, dernier tour, nombre de tours et somme pour la
+// moyenne) : zone 0x40 - 0x7F de l'EEPROM (parametres.h), 4 emplacements
+// de CHRONO_TAILLE octets écrits à tour de rôle. Chaque écriture va dans
+// l'emplacement suivant le plus récent, avec un numéro de plus : chaque
+// octet est réécrit 4 fois moins souvent, et une coupure pendant
+// l'écriture laisse intact le record précédent (CRC faux, emplacement
+// ignoré à la lecture).
+///////////////////////////////////////////////////////////////////////////////
+
+#include "reperes.h"
+
+#define CHRONO_LIGNE    REPERE_MARQUE_D     // départ et arrivée
+#define CHRONO_TOURS    4
+#define CHRONO_INTER    3
+
+#define CHRONO_ADRESSE  0x40
+#define CHRONO_TAILLE   16      // numéro, record, CRC
+#define CHRONO_PLACES   4
+
+struct chrono_tour {
+    unsigned long duree;                // us
+    unsigned long inter[CHRONO_INTER];  // us depuis le début du tour, 0 : aucun
+};
+
+struct chrono_record {
+    unsigned long meilleur;     // us, 0 : aucun tour
+    unsigned long dernier;      // us
+    unsigned int nombre;        // tours enregistrés
+    unsigned long somme;        // ms, pour la moyenne
+};
+
+extern struct chrono_record chronoRecord;
+
+// Au démarrage : lit le record le plus récent, à zéro si aucun n'est valide
+void chrono_charger(void);
+
+// Au départ de la course, date du front de FDC
+void chrono_depart(unsigned long date);
+
+// Repère lu dans la file de reperes.h (tâche de fond)
+void chrono_repere(const struct repere *r);
+
+// A l'arrêt, hors course, file des repères vidée : tours de la course
+// ajoutés au record, écrit en EEPROM (environ 4 ms par octet modifié) ;
+// normal : 1 si la course s'est arrêtée par JCK, sans défaut ni ligne
+// perdue
+void chrono_fin(unsigned long duree, char normal);
+
+// Tours de la course terminés
+unsigned char chrono_nombre(void);
+
+// Moyenne du record en ms, 0 sans tour
+unsigned long chrono_moyenne(void);
+
+// Envoie les tours de la course et le record :
+//   tour;n;duree;inter1;inter2;inter3
+//   record;meilleur;dernier;moyenne_ms;nombre
+void chrono_envoyer(void);
+
+#endif
@@ -0,0 +1,163 @@
+#include <xc.h>
+#include "iut_usb_cdc.h"
+#include "parametres.h"
+#include "asservissement.h"
+#include "console.h"
+
+#ifdef USB_CDC
+
+#define CONSOLE_LIGNE   16      // "p 10 -32768" et le '\0'
+#define CONSOLE_SORTIE  48      // ligne d'un paramètre, nom de 10 caractères
+
+static char (*consoleReglable)(void);
+
+static char ligne[CONSOLE_LIGNE];
+static unsigned char longueur;
+static char tropLongue;     // ligne ignorée jusqu'à sa fin
+
+// Réponse en cours : lignes des paramètres premier à dernier - 1, puis
+// le compte rendu
+static unsigned char sortie[CONSOLE_SORTIE];
+static unsigned char nbSortie;
+static unsigned char rang, premier, dernier;
+static const char *compteRendu;
+static struct minuterie delai;
+
+void console_init(char (*reglable)(void)) {
+    consoleReglable = reglable;
+    longueur = 0;
+    tropLongue = 0;
+}
+
+// Ligne complète, sans sa fin ; une ligne trop longue devient vide
+static char lireLigne(void) {
+    unsigned char c;
+
+    while (usb_cdc_lire(&c, 1)) {
+        if (c == '\r' || c == '\n') {
+            if (longueur == 0 && !tropLongue) continue;     // "\r\n"
+            ligne[tropLongue ? 0 : longueur] = '\0';
+            longueur = 0;
+            tropLongue = 0;
+            return 1;
+        }
+        if (longueur < CONSOLE_LIGNE - 1) {
+            ligne[longueur++] = c;
+        } else {
+            tropLongue = 1;
+        }
+    }
+    return 0;
+}
+
+static const char *espaces(const char *s) {
+    while (*s == ' ') s++;
+    return s;
+}
+
+// Entier signé de 5 chiffres au plus, précédé d'espaces ; renvoie 0 si
+// absent ou hors de l'int
+static char lireEntier(const char **s, int *n) {
+    const char *c = espaces(*s);
+    char negatif = (*c == '-');
+    unsigned char chiffres = 0;
+    long v = 0;
+
+    if (negatif) c++;
+    while (*c >= '0' && *c <= '9') {
+        if (++chiffres > 5) return 0;
+        v = v * 10 + (*c++ - '0');
+    }
+    if (chiffres == 0 || v > 32767) return 0;
+    *n = negatif ? -(int) v : (int) v;
+    *s = c;
+    return 1;
+}
+
+static void ajouter(const char *s) {
+    while (*s && nbSortie < CONSOLE_SORTIE) sortie[nbSortie++] = *s++;
+}
+
+static void ajouterEntier(int n) {
+    char chiffres[5];
+    unsigned char k = 0;
+    unsigned int u = (n < 0) ? -(unsigned int) n : (unsigned int) n;
+
+    if (n < 0) ajouter("-");
+    do {
+        chiffres[k++] = '0' + (u % 10);
+        u /= 10;
+    } while (u);
+    while (k && nbSortie < CONSOLE_SORTIE) sortie[nbSortie++] = chiffres[--k];
+}
+
+// param;rang;nom;valeur;min;max
+static void ajouterParametre(unsigned char r) {
+    const struct parametre *t = &parametresTable[r];
+
+    ajouter("param;");
+    ajouterEntier(r);
+    ajouter(";");
+    ajouter(t->nom);
+    ajouter(";");
+    ajouterEntier(param[r]);
+    ajouter(";");
+    ajouterEntier(t->min);
+    ajouter(";");
+    ajouterEntier(t->max);
+    ajouter("\r\n");
+}
+
+// Exécute la commande de ligne, fixe les paramètres à envoyer et renvoie
+// le compte rendu
+static const char *interpreter(void) {
+    const char *s = espaces(ligne);
+    const struct parametre *t;
+    int r, v;
+
+    premier = 0;
+    dernier = 0;
+    if (*s++ != 'p') return "erreur";
+    if (!consoleReglable()) return "occupe";
+    s = espaces(s);
+    if (*s == '\0') {
+        dernier = PARAM_NB;
+        return "ok";
+    }
+    if (!lireEntier(&s, &r) || !lireEntier(&s, &v) || *espaces(s) != '\0'
+            || r < 0 || r >= PARAM_NB) {
+        return "erreur";
+    }
+    t = &parametresTable[r];
+    if (v < t->min || v > t->max) return "erreur";
+
+    param[r] = v;
+    parametres_sauver();
+    asserv_gains(param[PARAM_KP], param[PARAM_KI]);
+    premier = (unsigned char) r;
+    dernier = premier + 1;
+    return "ok";
+}
+
+char console_servir(struct pt *pt) {
+    PT_DEBUT(pt);
+    if (lireLigne()) {
+        compteRendu = interpreter();
+        for (rang = premier; rang <= dernier; rang++) {
+            nbSortie = 0;
+            if (rang < dernier) {
+                ajouterParametre(rang);
+            } else {
+                ajouter(compteRendu);
+                ajouter("\r\n");
+            }
+            minuterie_armer(&delai, CONSOLE_DELAI);
+            PT_ATTENDRE_QUE(pt, usb_cdc_place() >= nbSortie
+                    || minuterie_echue(&delai));
+            usb_cdc_ecrire(sortie, nbSortie);
+        }
+    }
+    PT_FIN(pt);
+}
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Réglage des paramètres depuis le PC, sur le port série virtuel USB
+// (compilé avec -DUSB_CDC)
+//
+// Une commande par ligne, terminée par '\r' ou '\n' :
+//   p          liste les paramètres, une ligne chacun
+//   p r v      donne la valeur v au paramètre de rang r, l'enregistre en
+//              EEPROM et applique les gains, puis renvoie sa ligne
+// Ligne d'un paramètre :
+//   param;rang;nom;valeur;min;max
+// Chaque commande se termine par une ligne "ok", "erreur" (commande
+// inconnue, rang ou valeur hors bornes) ou "occupe" (hors de l'arrêt :
+// rien n'est lu ni modifié pendant une course).
+//
+// Les réponses attendent la place dans le tampon d'émission USB
+// CONSOLE_DELAI tics au plus, puis sont perdues : un PC qui ne lit pas ne
+// bloque pas les tâches suivantes.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "iut_taches.h"
+
+#define CONSOLE_DELAI   100     // tics
+
+// Après usb_cdc_init ; reglable renvoie 1 quand les paramètres peuvent
+// changer
+void console_init(char (*reglable)(void));
+
+// Tâche de fond : lit une commande et y répond
+char console_servir(struct pt *pt);
+
+#endif
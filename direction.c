@@ -0,0 +1,72 @@
+#include <xc.h>
+#include "direction.h"
+
+// Ecart au centre du milieu de la case i
+#define DIRECTION_X(i)      ((2L * (i) - (DIRECTION_NB - 1)) * DIRECTION_LARGEUR / 2)
+#define DIRECTION_ABS(x)    ((x) < 0 ? -(x) : (x))
+#define DIRECTION_ECART(i)  (DIRECTION_ECART_MAX * DIRECTION_X(i) \
+        / (DIRECTION_ABS(DIRECTION_X(i)) + DIRECTION_K))
+#define DIRECTION_ETAT(i)   (DIRECTION_ECART(i) > DIRECTION_SEUIL_VIRAGE ? 1 \
+        : DIRECTION_ECART(i) < -DIRECTION_SEUIL_VIRAGE ? 2 : 0)
+
+// Demi-écart rapporté à DIRECTION_BASE, x 256
+#define DIRECTION_ENTREE(i) {(int) (DIRECTION_ECART(i) * 128 / DIRECTION_BASE), \
+        DIRECTION_ETAT(i)}
+#define DIRECTION_4(i)      DIRECTION_ENTREE(i), DIRECTION_ENTREE(i + 1), \
+        DIRECTION_ENTREE(i + 2), DIRECTION_ENTREE(i + 3)
+
+// Demi-écart toujours inférieur à la vitesse : rapports cycliques positifs
+#if DIRECTION_ECART_MAX / 2 >= DIRECTION_BASE
+#error "DIRECTION_ECART_MAX / 2 doit rester sous DIRECTION_BASE"
+#endif
+
+#if DIRECTION_NB != 32
+#error "directionTable : 8 x DIRECTION_4 à adapter à DIRECTION_NB"
+#endif
+
+struct direction_case {
+    int demi_ecart_q8;
+    unsigned char etat;
+};
+
+static const struct direction_case directionTable[DIRECTION_NB] = {
+    DIRECTION_4(0), DIRECTION_4(4), DIRECTION_4(8), DIRECTION_4(12),
+    DIRECTION_4(16), DIRECTION_4(20), DIRECTION_4(24), DIRECTION_4(28)
+};
+
+static unsigned char rang = DIRECTION_NB / 2;
+
+void direction_init(void) {
+    rang = DIRECTION_NB / 2;
+}
+
+void direction_lire(int position, int centre, unsigned int vitesse,
+        struct direction *d) {
+    int x = position - centre + DIRECTION_NB / 2 * DIRECTION_LARGEUR;
+    unsigned char n;
+    int demi;
+
+    if (x < 0) {
+        n = 0;
+    } else if (x >= DIRECTION_NB * DIRECTION_LARGEUR) {
+        n = DIRECTION_NB - 1;
+    } else {
+        n = (unsigned char) (x >> DIRECTION_DECALAGE);
+    }
+#if DIRECTION_HYSTERESIS
+    if (n != rang) {
+        int bas = (int) rang << DIRECTION_DECALAGE;
+
+        if (x < bas - DIRECTION_HYSTERESIS
+                || x >= bas + DIRECTION_LARGEUR + DIRECTION_HYSTERESIS) {
+            rang = n;
+        }
+    }
+#else
+    rang = n;
+#endif
+    demi = (int) (((long) directionTable[rang].demi_ecart_q8 * vitesse) >> 8);
+    d->droit = vitesse + demi;
+    d->gauche = vitesse - demi;
+    d->etat = directionTable[rang].etat;
+}
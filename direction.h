@@ -0,0 +1,52 @@
+#ifndef DIRECTION_H
+#define DIRECTION_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Direction par table (compilée avec -DDIRECTION_TABLE)
+//
+// La position prédite est découpée en DIRECTION_NB cases de
+// DIRECTION_LARGEUR, centrées sur le centre réglé (param[PARAM_CENTRE],
+// passé à chaque appel). Pour chaque case, la table directionTable
+// (constante, en mémoire programme) donne le demi-écart droit - gauche
+// rapporté à la vitesse de référence, et l'état de direction équivalent
+// (0 tout droit, 1 droite, 2 gauche) pour la carte de la piste.
+//
+// La table est calculée par le préprocesseur à partir d'une courbe
+// continue, l'écart droit - gauche en fonction de l'écart x au centre,
+// pour une vitesse de référence DIRECTION_BASE :
+//   ecart(x) = DIRECTION_ECART_MAX . x / (|x| + DIRECTION_K)
+// linéaire près du centre, saturé loin de la ligne. A l'exécution,
+// l'écart est mis à l'échelle de la vitesse réglée (param[PARAM_VITESSE]) :
+// une lecture de table, une multiplication et un décalage par boucle,
+// quelle que soit la courbe.
+//
+// Hystérésis : la case ne change que si la position sort de la case
+// courante de plus de DIRECTION_HYSTERESIS (0 : pas d'hystérésis).
+///////////////////////////////////////////////////////////////////////////////
+
+#define DIRECTION_NB        32
+#define DIRECTION_DECALAGE  4
+#define DIRECTION_LARGEUR   (1 << DIRECTION_DECALAGE)
+#define DIRECTION_HYSTERESIS 4
+
+// Courbe de direction, rapports cycliques pour la vitesse DIRECTION_BASE
+#define DIRECTION_BASE      150L
+#define DIRECTION_ECART_MAX 200L
+#define DIRECTION_K         64L
+#define DIRECTION_SEUIL_VIRAGE  50L // écart au-delà duquel on tourne
+
+struct direction {
+    unsigned int droit;     // rapport cyclique de référence, moteur droit
+    unsigned int gauche;    // moteur gauche
+    unsigned char etat;     // 0 tout droit, 1 droite, 2 gauche
+};
+
+// Au départ : case centrale
+void direction_init(void);
+
+// Rapports cycliques pour la position prédite, autour de centre, à la
+// vitesse de référence vitesse
+void direction_lire(int position, int centre, unsigned int vitesse,
+        struct direction *d);
+
+#endif
@@ -0,0 +1,91 @@
+#include <xc.h>
+#include "iut_temps.h"
+#include "entrees.h"
+
+static struct evenement file[ENTREES_FILE];
+static volatile unsigned char fileEcriture = 0, fileLecture = 0;
+
+static volatile char fdcNiveau, jckNiveau;
+static volatile unsigned long fdcInstant, jckInstant;
+
+// Ajout d'un événement, appelé depuis la routine haute ou depuis la routine
+// basse avec la routine haute masquée : un seul producteur à la fois.
+// File pleine : l'événement est perdu, les niveaux filtrés restent justes.
+static void ajouter(unsigned char type, unsigned long instant) {
+    unsigned char suivant = (fileEcriture + 1) & (ENTREES_FILE - 1);
+
+    if (suivant == fileLecture) return;
+    file[fileEcriture].type = type;
+    file[fileEcriture].instant = instant;
+    fileEcriture = suivant;
+}
+
+void entrees_init(void) {
+    unsigned long t = temps_lire();
+
+    TRISBbits.TRISB2 = 1;
+    TRISEbits.TRISE2 = 1;
+    fdcNiveau = PORTBbits.RB2;
+    jckNiveau = PORTEbits.RE2;
+    // on laisse passer tout de suite le premier changement
+    fdcInstant = t - ENTREES_ANTIREBOND;
+    jckInstant = t - ENTREES_ANTIREBOND;
+
+    INTCON2bits.INTEDG2 = !fdcNiveau;   // front attendu : vers l'autre niveau
+    INTCON3bits.INT2IF = 0;
+    INTCON3bits.INT2IE = 1;
+}
+
+void entrees_it(void) {
+    unsigned long t = temps_lire();
+
+    INTCON3bits.INT2IF = 0;
+    // entrees_scruter (routine haute) modifie les mêmes variables
+    INTCONbits.GIEH = 0;
+    if (t - fdcInstant >= ENTREES_ANTIREBOND) { // sinon rebond
+        fdcNiveau = INTCON2bits.INTEDG2;    // front montant => niveau haut
+        INTCON2bits.INTEDG2 = !fdcNiveau;
+        fdcInstant = t;
+        ajouter(fdcNiveau ? EVT_FDC_HAUT : EVT_FDC_BAS, t);
+    }
+    INTCONbits.GIEH = 1;
+}
+
+void entrees_scruter(void) {
+    unsigned long t;
+    char niveau;
+
+    // appelée depuis la routine haute : rien ne peut l'interrompre
+    t = temps_lire();
+    // FDC : un front perdu pendant l'anti-rebond est rattrapé ici
+    niveau = PORTBbits.RB2;
+    if (niveau != fdcNiveau && t - fdcInstant >= ENTREES_ANTIREBOND) {
+        fdcNiveau = niveau;
+        INTCON2bits.INTEDG2 = !niveau;
+        INTCON3bits.INT2IF = 0;
+        fdcInstant = t;
+        ajouter(niveau ? EVT_FDC_HAUT : EVT_FDC_BAS, t);
+    }
+    // JCK : scruté, même anti-rebond
+    niveau = PORTEbits.RE2;
+    if (niveau != jckNiveau && t - jckInstant >= ENTREES_ANTIREBOND) {
+        jckNiveau = niveau;
+        jckInstant = t;
+        ajouter(niveau ? EVT_JCK_HAUT : EVT_JCK_BAS, t);
+    }
+}
+
+char entrees_lire(struct evenement *e) {
+    if (fileLecture == fileEcriture) return 0;
+    *e = file[fileLecture];
+    fileLecture = (fileLecture + 1) & (ENTREES_FILE - 1);
+    return 1;
+}
+
+char entrees_fdc(void) {
+    return fdcNiveau;
+}
+
+char entrees_jck(void) {
+    return jckNiveau;
+}
@@ -0,0 +1,58 @@
+#ifndef ENTREES_H
+#define ENTREES_H
+
+#include "iut_temps.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Entrées de départ et d'arrêt : FDC (RB2) et JCK (RE2)
+//
+// Chaque changement de niveau filtré devient un événement daté, rangé
+// dans une file que la machine d'état de main() vide à chaque tour.
+//
+// FDC est sur RB2/INT2 : le front est détecté par interruption et daté
+// à quelques microsecondes près, sans attendre le tour de boucle.
+// JCK est sur RE2, qui n'a pas d'interruption sur le PIC18F4550 : il est
+// scruté par entrees_scruter() à chaque tic de commande (priorité haute)
+// et daté au moment de la scrutation, soit avec 1 tic de retard au plus.
+//
+// Anti-rebond : le premier front est pris en compte tout de suite, les
+// fronts suivants sont ignorés pendant ENTREES_ANTIREBOND. A la fin de
+// cette fenêtre, entrees_scruter() relit le niveau et corrige si un
+// rebond a laissé l'entrée dans l'autre état.
+///////////////////////////////////////////////////////////////////////////////
+
+// Durée de l'anti-rebond en pas de la base de temps (20 ms)
+#define ENTREES_ANTIREBOND  (20 * TEMPS_PAR_MS)
+
+// Taille de la file d'événements (puissance de 2)
+#define ENTREES_FILE        8
+
+// Types d'événements
+#define EVT_FDC_HAUT    1   // FDC passe à 1 : départ
+#define EVT_FDC_BAS     2   // FDC passe à 0 : retour à l'arrêt
+#define EVT_JCK_HAUT    3
+#define EVT_JCK_BAS     4   // JCK passe à 0 : fin de course
+
+struct evenement {
+    unsigned char type;
+    unsigned long instant;  // date de l'événement (base de temps iut_temps)
+};
+
+// Lit les niveaux de départ et autorise l'interruption INT2
+// (temps_init doit avoir été appelé)
+void entrees_init(void);
+
+// Routine de l'interruption INT2, à enregistrer en priorité basse
+void entrees_it(void);
+
+// A appeler depuis le tic de priorité haute : scrute JCK et resynchronise FDC
+void entrees_scruter(void);
+
+// Retire le plus ancien événement de la file, renvoie 0 si elle est vide
+char entrees_lire(struct evenement *e);
+
+// Niveaux filtrés
+char entrees_fdc(void);
+char entrees_jck(void);
+
+#endif
@@ -0,0 +1,41 @@
+#include <xc.h>
+#include "estimateur.h"
+
+static long x;          // position, Q8
+static long v;          // dérive due à la piste, Q8 par tic
+static long commande;   // effet de la commande, Q8 par tic
+static int derniere;    // dernière mesure
+
+void estim_init(int mesure) {
+    x = (long) mesure << 8;
+    v = 0;
+    commande = 0;
+    derniere = mesure;
+}
+
+void estim_mettre_a_jour(int mesure, int differentiel) {
+    long r;
+
+    derniere = mesure;
+    commande = ((long) differentiel * ESTIM_B_Q16) >> 8;
+    x += v - commande;
+    r = ((long) mesure << 8) - x;
+    x += (r * ESTIM_ALPHA_Q8 + 128) >> 8;   // arrondi au plus proche
+    v += (r * ESTIM_BETA_Q8 + 128) >> 8;   // arrondi au plus proche
+}
+
+int estim_position(void) {
+    return (int) (x >> 8);
+}
+
+int estim_prediction(void) {
+#ifndef SANS_PREDICTION
+    long p = (x + (v - commande) * ESTIM_AVANCE) >> 8;
+
+    if (p > 1023) p = 1023;
+    if (p < -1023) p = -1023;
+    return (int) p;
+#else
+    return derniere;
+#endif
+}
@@ -0,0 +1,52 @@
+#ifndef ESTIMATEUR_H
+#define ESTIMATEUR_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Estimation et prédiction de la position de la ligne
+//
+// La position mesurée (CD - CG) a déjà un tour de boucle externe de retard
+// quand la nouvelle consigne agit sur les moteurs. Un filtre alpha-bêta
+// en virgule fixe (Q8) estime, à chaque tic :
+//   - x : la position de la ligne ;
+//   - v : sa dérive par tic due à la piste (virage), hors commande.
+// La commande (différence des consignes droite - gauche, en fronts/s) est
+// connue : elle déplace la position de ESTIM_B par tic et par front/s.
+//
+//   prédiction :  x = x + v - B.u
+//   correction :  r = mesure - x ;  x = x + alpha.r ;  v = v + beta.r
+//
+// estim_prediction() donne la position attendue ESTIM_AVANCE tics plus
+// tard : une période de la boucle externe plus le retard pur du moteur,
+// soit le délai entre la mesure et son effet sur les roues.
+//
+// alpha = 0,5 ; beta = alpha² / (2 - alpha) : réponse sans dépassement
+// (Benedict-Bordner). ESTIM_B est à mesurer sur la piste : pente de la
+// position pour un écart de vitesse connu entre les roues.
+//
+// Avec -DSANS_PREDICTION, estim_prediction() rend la dernière mesure :
+// comparaison à la piste avec et sans prédiction.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "asservissement.h"
+
+#define ESTIM_ALPHA_Q8  128     // 0,5
+#define ESTIM_BETA_Q8   43      // 0,167
+#define ESTIM_B_Q16     20      // unités de position par tic et par front/s
+
+// Horizon de prédiction en tics (1 ms)
+#define ESTIM_AVANCE    (ASSERV_DIVISEUR + MOTEUR_RETARD_MS)
+
+// Position de départ, dérive nulle
+void estim_init(int mesure);
+
+// A chaque tic, priorité haute : mesure et écart des consignes droite -
+// gauche appliqué pendant le tic écoulé
+void estim_mettre_a_jour(int mesure, int differentiel);
+
+// Position filtrée
+int estim_position(void);
+
+// Position prédite dans ESTIM_AVANCE tics, bornée à +/- 1023
+int estim_prediction(void);
+
+#endif
@@ -0,0 +1,182 @@
+#include <xc.h>
+#include "iut_pwm.h"
+#include "iut_uart.h"
+#include "iut_codeurs.h"
+#include "iut_taches.h"
+#include "identification.h"
+
+#ifdef IDENTIFICATION
+
+static unsigned int vitesses[2][IDENT_NB];
+// Rapport cyclique de chaque échantillon, un bit : 1 pour IDENT_RC_HAUT,
+// 0 pour IDENT_RC_BAS, les deux seuls niveaux de l'essai
+static unsigned char niveaux[(IDENT_NB + 7) / 8];
+
+static volatile unsigned char etatEssai = IDENT_ATTENTE;
+static volatile char aEnvoyer = 0;  // essai terminé, relevé pas envoyé
+static unsigned char rang;          // échantillon en cours
+static unsigned char tics;          // tics depuis le dernier échantillon
+static unsigned char sbpa;          // registre de la SBPA
+static unsigned int rcEssai;
+
+// Rapport cyclique appliqué pendant l'échantillon k
+static unsigned int excitation(unsigned char k) {
+    if (k < IDENT_NB / 4) return IDENT_RC_BAS;
+    if (k < IDENT_NB / 2) return IDENT_RC_HAUT;
+    if ((k - IDENT_NB / 2) % IDENT_BIT == 0) {
+        // x^7 + x^6 + 1 : période de 127 bits
+        sbpa = (sbpa << 1) | (((sbpa >> 6) ^ (sbpa >> 5)) & 1);
+    }
+    return (sbpa & 1) ? IDENT_RC_HAUT : IDENT_RC_BAS;
+}
+
+void identification_lancer(void) {
+    if (etatEssai == IDENT_EN_COURS || aEnvoyer) return;
+    rang = 0;
+    tics = 0;
+    sbpa = 0x5A;
+    rcEssai = excitation(0);
+    etatEssai = IDENT_EN_COURS;
+}
+
+void identification_tic(void) {
+    if (etatEssai != IDENT_EN_COURS) {
+        pwm_setdc1(0);
+        pwm_setdc2(0);
+        return;
+    }
+    pwm_setdc1(rcEssai);
+    pwm_setdc2(rcEssai);
+    if (++tics < IDENT_PERIODE) return;
+
+    // fin de l'échantillon : vitesse atteinte avec rcEssai
+    tics = 0;
+    if (rcEssai == IDENT_RC_HAUT) {
+        niveaux[rang >> 3] |= 1 << (rang & 7);
+    } else {
+        niveaux[rang >> 3] &= ~(1 << (rang & 7));
+    }
+    vitesses[CODEUR_DROIT][rang] = codeurs_vitesse(CODEUR_DROIT);
+    vitesses[CODEUR_GAUCHE][rang] = codeurs_vitesse(CODEUR_GAUCHE);
+    if (++rang >= IDENT_NB) {
+        pwm_setdc1(0);
+        pwm_setdc2(0);
+        etatEssai = IDENT_FINI;
+        aEnvoyer = 1;
+        return;
+    }
+    rcEssai = excitation(rang);
+}
+
+unsigned char identification_etat(void) {
+    return etatEssai;
+}
+
+// Moyenne des 5 derniers échantillons avant le rang fin (palier établi)
+static unsigned int palier(const unsigned int *v, unsigned char fin) {
+    unsigned char k;
+    unsigned long somme = 0;
+
+    for (k = fin - 5; k < fin; k++) somme += v[k];
+    return (unsigned int) (somme / 5);
+}
+
+// Premier échantillon du second échelon où la vitesse dépasse
+// bas + saut x fraction / 1000, en ms depuis l'échelon
+static unsigned int atteinte(const unsigned int *v, unsigned int bas,
+        unsigned int saut, unsigned int fraction) {
+    unsigned char k;
+    unsigned int seuil = bas + (unsigned int) ((unsigned long) saut * fraction / 1000);
+
+    for (k = IDENT_NB / 4; k < IDENT_NB / 2; k++) {
+        if (v[k] >= seuil) break;
+    }
+    return (k - IDENT_NB / 4) * IDENT_PERIODE;
+}
+
+char identification_modele(unsigned char roue, struct modele *m) {
+    const unsigned int *v = vitesses[roue];
+    unsigned int bas, haut, t28, t63, tau;
+    long mort;
+
+    bas = palier(v, IDENT_NB / 4);
+    haut = palier(v, IDENT_NB / 2);
+    if (haut <= bas) return 0;
+
+    // vitesse = (rc - mort) x gain
+    m->gain_q8 = (unsigned int) (((unsigned long) (haut - bas) << 8)
+            / (IDENT_RC_HAUT - IDENT_RC_BAS));
+    if (m->gain_q8 == 0) return 0;
+    mort = IDENT_RC_BAS - (long) ((((unsigned long) bas) << 8) / m->gain_q8);
+    m->mort = (mort > 0) ? (unsigned int) mort : 0;
+
+    t28 = atteinte(v, bas, haut - bas, 283);
+    t63 = atteinte(v, bas, haut - bas, 632);
+    tau = 3 * (t63 - t28) / 2;
+    m->tau_ms = tau;
+    m->retard_ms = (t63 > tau) ? t63 - tau : 0;
+    return 1;
+}
+
+static void envoyerDefine(const char *nom, unsigned int valeur) {
+    uart_puts("#define ");
+    uart_puts(nom);
+    uart_putc(' ');
+    uart_putu(valeur);
+    uart_puts("\r\n");
+}
+
+// Une ligne par pas : la boucle principale (et le chien de garde) passe
+// entre deux lignes
+char identification_envoyer(struct pt *pt) {
+    static unsigned char k, r;
+    static struct modele m[2];
+    static char valide[2];
+
+    PT_DEBUT(pt);
+    PT_ATTENDRE_QUE(pt, aEnvoyer);
+    uart_puts("# identification, un echantillon toutes les ");
+    uart_putu(IDENT_PERIODE);
+    uart_puts(" ms\r\nt_ms;rc;v_droit;v_gauche\r\n");
+    for (k = 0; k < IDENT_NB; k++) {
+        uart_putu((unsigned long) k * IDENT_PERIODE);
+        uart_putc(';');
+        uart_putu((niveaux[k >> 3] & (1 << (k & 7))) ? IDENT_RC_HAUT
+                : IDENT_RC_BAS);
+        uart_putc(';');
+        uart_putu(vitesses[CODEUR_DROIT][k]);
+        uart_putc(';');
+        uart_putu(vitesses[CODEUR_GAUCHE][k]);
+        uart_puts("\r\n");
+        PT_CEDER(pt);
+    }
+
+    for (r = 0; r < 2; r++) {
+        valide[r] = identification_modele(r, &m[r]);
+        uart_puts(r == CODEUR_DROIT ? "// droit" : "// gauche");
+        if (!valide[r]) {
+            uart_puts(" : pas de reponse\r\n");
+            continue;
+        }
+        uart_puts(" : mort ");
+        uart_putu(m[r].mort);
+        uart_puts(" gain_q8 ");
+        uart_putu(m[r].gain_q8);
+        uart_puts(" tau_ms ");
+        uart_putu(m[r].tau_ms);
+        uart_puts(" retard_ms ");
+        uart_putu(m[r].retard_ms);
+        uart_puts("\r\n");
+    }
+    // un seul modèle pour les deux moteurs dans asservissement.h
+    if (valide[0] && valide[1]) {
+        envoyerDefine("MOTEUR_MORT", (m[0].mort + m[1].mort) / 2);
+        envoyerDefine("MOTEUR_GAIN_Q8", (m[0].gain_q8 + m[1].gain_q8) / 2);
+        envoyerDefine("MOTEUR_TAU_MS", (m[0].tau_ms + m[1].tau_ms) / 2);
+        envoyerDefine("MOTEUR_RETARD_MS", (m[0].retard_ms + m[1].retard_ms) / 2);
+    }
+    aEnvoyer = 0;
+    PT_FIN(pt);
+}
+
+#endif
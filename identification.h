@@ -0,0 +1,63 @@
+#ifndef IDENTIFICATION_H
+#define IDENTIFICATION_H
+
+#include "iut_taches.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Identification des moteurs (mode d'essai, robot sur cales, compilé avec
+// -DIDENTIFICATION : le relevé occupe plus de 800 octets de RAM)
+//
+// Mode choisi au démarrage en maintenant FDC appuyé. Un appui sur FDC
+// lance l'essai, appliqué aux deux moteurs en même temps :
+//   - échelon 0 -> IDENT_RC_BAS pendant 1/4 de l'essai
+//   - échelon IDENT_RC_BAS -> IDENT_RC_HAUT pendant 1/4 de l'essai
+//   - séquence binaire pseudo-aléatoire (SBPA, registre 7 bits) entre
+//     les deux niveaux, un bit tous les IDENT_BIT échantillons
+// La vitesse des deux roues (iut_codeurs.h) est relevée tous les
+// IDENT_PERIODE tics dans un tableau en RAM.
+//
+// A la fin, un modèle du premier ordre avec retard est ajusté pour chaque
+// roue sur le second échelon, par la méthode des deux points (Smith) :
+//   t28 et t63 : instants où la vitesse a fait 28,3 % et 63,2 % du saut
+//   T = 1,5 x (t63 - t28), retard L = t63 - T
+//   gain K = saut de vitesse / saut de rapport cyclique
+//   zone morte = IDENT_RC_BAS - vitesse au palier bas / K
+// Le relevé complet (CSV) puis les paramètres, sous forme de #define à
+// recopier dans asservissement.h, sont envoyés sur la liaison série.
+///////////////////////////////////////////////////////////////////////////////
+
+#define IDENT_NB        200     // échantillons par roue
+#define IDENT_PERIODE   5       // tics entre 2 échantillons (5 ms)
+#define IDENT_BIT       4       // échantillons par bit de la SBPA
+#define IDENT_RC_BAS    150
+#define IDENT_RC_HAUT   250
+
+// Etats de l'essai
+#define IDENT_ATTENTE   0
+#define IDENT_EN_COURS  1
+#define IDENT_FINI      2
+
+struct modele {
+    unsigned int mort;          // rapport cyclique de démarrage
+    unsigned int gain_q8;       // fronts/s par unité de rc, x 256
+    unsigned int tau_ms;        // constante de temps
+    unsigned int retard_ms;     // retard pur
+};
+
+// Démarre l'essai (depuis la boucle principale)
+void identification_lancer(void);
+
+// A chaque tic de commande, à la place de l'asservissement :
+// applique le rapport cyclique de l'essai et relève les vitesses
+void identification_tic(void);
+
+unsigned char identification_etat(void);
+
+// Modèle ajusté pour une roue (CODEUR_DROIT ou CODEUR_GAUCHE),
+// l'essai doit être terminé ; renvoie 0 si l'échelon n'a rien donné
+char identification_modele(unsigned char roue, struct modele *m);
+
+// Tâche d'envoi du relevé et des paramètres une fois l'essai terminé
+char identification_envoyer(struct pt *pt);
+
+#endif
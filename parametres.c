@@ -0,0 +1,59 @@
+#include <xc.h>
+#include "iut_eeprom.h"
+#include "asservissement.h"
+#include "parametres.h"
+
+const struct parametre parametresTable[PARAM_NB] = {
+    {"vitesse", 150, 60, 400},
+    {"virage ext", 200, 60, 500},
+    {"virage int", 100, MOTEUR_MORT, 400},   // en dessous, roue arrêtée
+    {"seuil D", -142, -600, 200},
+    {"seuil G", -292, -600, 200},
+    {"centre", -217, -600, 200},
+    {"fond", 200, 0, 1023},
+    {"Kp x256", 13, 0, 100},
+    {"Ki x256", 1, 0, 20},
+    {"plein", 850, 0, 1023},
+};
+
+int param[PARAM_NB];
+
+// Adresse du CRC, après la version et les valeurs
+#define PARAM_CRC   (PARAM_ADRESSE + 1 + 2 * PARAM_NB)
+
+char parametres_charger(void) {
+    unsigned char n, adresse, lo, hi, crc;
+
+    crc = eeprom_crc8(0, eeprom_lire(PARAM_ADRESSE));
+    adresse = PARAM_ADRESSE + 1;
+    for (n = 0; n < PARAM_NB; n++) {
+        lo = eeprom_lire(adresse++);
+        hi = eeprom_lire(adresse++);
+        crc = eeprom_crc8(eeprom_crc8(crc, lo), hi);
+        param[n] = (int) (((unsigned int) hi << 8) | lo);
+    }
+    if (eeprom_lire(PARAM_ADRESSE) == PARAM_VERSION
+            && eeprom_lire(PARAM_CRC) == crc) {
+        return 1;
+    }
+    for (n = 0; n < PARAM_NB; n++) {
+        param[n] = parametresTable[n].defaut;
+    }
+    return 0;
+}
+
+void parametres_sauver(void) {
+    unsigned char n, adresse, lo, hi, crc;
+
+    eeprom_ecrire(PARAM_ADRESSE, PARAM_VERSION);
+    crc = eeprom_crc8(0, PARAM_VERSION);
+    adresse = PARAM_ADRESSE + 1;
+    for (n = 0; n < PARAM_NB; n++) {
+        lo = (unsigned char) param[n];
+        hi = (unsigned char) ((unsigned int) param[n] >> 8);
+        eeprom_ecrire(adresse++, lo);
+        eeprom_ecrire(adresse++, hi);
+        crc = eeprom_crc8(eeprom_crc8(crc, lo), hi);
+    }
+    eeprom_ecrire(PARAM_CRC, crc);
+}
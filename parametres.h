@@ -0,0 +1,54 @@
+#ifndef PARAMETRES_H
+#define PARAMETRES_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Paramètres réglables sans recompiler, conservés en EEPROM
+//
+// Les paramètres sont des entiers, rangés dans param[] et décrits par
+// parametresTable (nom affiché, valeur par défaut, bornes du réglage).
+// En EEPROM, le bloc est : version, valeurs (poids faible en premier),
+// CRC-8 (polynôme 0x07) de la version et des valeurs. Au démarrage, un
+// bloc d'une autre version ou au CRC faux est ignoré : valeurs par défaut.
+// Changer la liste des paramètres impose d'augmenter PARAM_VERSION.
+//
+// Plan de l'EEPROM (256 octets)
+//   0x00 - 0x3F  paramètres
+//   0x40 - 0x7F  meilleur tour
+//   0x80 - 0xFF  enregistreur de course
+///////////////////////////////////////////////////////////////////////////////
+
+#define PARAM_ADRESSE   0x00
+#define PARAM_VERSION   2
+
+// Rangs dans param[]
+#define PARAM_VITESSE   0   // rc de référence, tout droit
+#define PARAM_EXTERIEUR 1   // rc de référence, roue extérieure en virage
+#define PARAM_INTERIEUR 2   // rc de référence, roue intérieure en virage
+#define PARAM_SEUIL_D   3   // position : on tourne à droite au-delà
+#define PARAM_SEUIL_G   4   // position : on tourne à gauche en deçà
+#define PARAM_CENTRE    5   // position quand la ligne est au milieu
+#define PARAM_FOND      6   // CD et CG en dessous : ligne non vue
+#define PARAM_KP        7   // gains du PI de vitesse, Q8
+#define PARAM_KI        8
+#define PARAM_PLEIN     9   // CD et CG au-dessus : capteur sur un repère
+#define PARAM_NB        10
+
+struct parametre {
+    const char *nom;        // 10 caractères au plus (LCD)
+    int defaut;
+    int min;
+    int max;
+};
+
+extern const struct parametre parametresTable[PARAM_NB];
+extern int param[PARAM_NB];
+
+// Lit le bloc en EEPROM ; renvoie 1 s'il est valide, sinon charge les
+// valeurs par défaut et renvoie 0
+char parametres_charger(void);
+
+// Ecrit le bloc en EEPROM (environ 4 ms par octet modifié, à appeler
+// hors course)
+void parametres_sauver(void);
+
+#endif
@@ -0,0 +1,146 @@
+#include <xc.h>
+#include "iut_codeurs.h"
+#include "iut_uart.h"
+#include "parametres.h"
+#include "reperes.h"
+
+// Motifs des deux capteurs
+#define MOTIF_LIGNE     0
+#define MOTIF_BLANC     1
+#define MOTIF_DROITE    2
+#define MOTIF_GAUCHE    3
+#define MOTIF_FOND      4
+
+static struct repere file[REPERES_FILE];
+static volatile unsigned char fileEcriture = 0, fileLecture = 0;
+static unsigned int nombres[REPERE_NB];
+
+static unsigned long origine;       // distance au départ
+static unsigned char motif;         // motif confirmé en cours
+static unsigned char candidat;      // motif en attente de confirmation
+static unsigned char nbCandidat;
+static unsigned long debutDate, debutDistance;
+
+static unsigned long distance(void) {
+    return (codeurs_nombre(CODEUR_DROIT) + codeurs_nombre(CODEUR_GAUCHE)) / 2;
+}
+
+static unsigned char lireMotif(int cg, int cd) {
+    char pleinG = (cg >= param[PARAM_PLEIN]);
+    char pleinD = (cd >= param[PARAM_PLEIN]);
+
+    if (pleinG && pleinD) return MOTIF_BLANC;
+    if (pleinD && cg >= param[PARAM_FOND]) return MOTIF_DROITE;
+    if (pleinG && cd >= param[PARAM_FOND]) return MOTIF_GAUCHE;
+    if (cg < param[PARAM_FOND] && cd < param[PARAM_FOND]) return MOTIF_FOND;
+    return MOTIF_LIGNE;
+}
+
+// Longueur maximale d'un repère pour un motif, 0 : pas de repère
+static unsigned int longueurMax(unsigned char m) {
+    switch (m) {
+        case MOTIF_BLANC:
+            return REPERES_CROISEMENT_MAX;
+        case MOTIF_DROITE:
+        case MOTIF_GAUCHE:
+            return REPERES_MARQUE_MAX;
+        case MOTIF_FOND:
+            return REPERES_TROU_MAX;
+        default:
+            return 0;
+    }
+}
+
+// File pleine : le repère est perdu, les compteurs restent justes
+static void ajouter(unsigned char type, unsigned int longueur) {
+    unsigned char suivant = (fileEcriture + 1) & (REPERES_FILE - 1);
+
+    nombres[type]++;
+    if (suivant == fileLecture) return;
+    file[fileEcriture].type = type;
+    file[fileEcriture].date = debutDate;
+    file[fileEcriture].distance = debutDistance - origine;
+    file[fileEcriture].longueur = longueur;
+    fileEcriture = suivant;
+}
+
+// Fin du motif en cours : repère s'il est assez court
+static void terminer(unsigned long d) {
+    unsigned long longueur = d - debutDistance;
+
+    if (longueur > longueurMax(motif)) return;
+    switch (motif) {
+        case MOTIF_BLANC:
+            ajouter(REPERE_CROISEMENT, (unsigned int) longueur);
+            break;
+        case MOTIF_DROITE:
+            ajouter(REPERE_MARQUE_D, (unsigned int) longueur);
+            break;
+        case MOTIF_GAUCHE:
+            ajouter(REPERE_MARQUE_G, (unsigned int) longueur);
+            break;
+        case MOTIF_FOND:
+            ajouter(REPERE_TROU, (unsigned int) longueur);
+            break;
+    }
+}
+
+void reperes_depart(void) {
+    unsigned char n;
+
+    origine = distance();
+    motif = MOTIF_LIGNE;
+    candidat = MOTIF_LIGNE;
+    nbCandidat = 0;
+    for (n = 0; n < REPERE_NB; n++) nombres[n] = 0;
+}
+
+char reperes_tic(unsigned long date, int cg, int cd) {
+    unsigned char m = lireMotif(cg, cd);
+    unsigned long d = distance();
+
+    if (m == motif) {
+        nbCandidat = 0;
+    } else {
+        if (m != candidat) {
+            candidat = m;
+            nbCandidat = 0;
+        }
+        if (++nbCandidat >= REPERES_CONFIRMATION) {
+            terminer(d);
+            motif = m;
+            nbCandidat = 0;
+            debutDate = date;
+            debutDistance = d;
+        }
+    }
+
+    // position à ignorer pendant ce qui peut encore être un repère, y
+    // compris pendant la confirmation d'un croisement ou d'une marque
+    if (m == MOTIF_BLANC || m == MOTIF_DROITE || m == MOTIF_GAUCHE) {
+        return m != motif || d - debutDistance <= longueurMax(m);
+    }
+    return 0;
+}
+
+char reperes_lire(struct repere *r) {
+    if (fileLecture == fileEcriture) return 0;
+    *r = file[fileLecture];
+    fileLecture = (fileLecture + 1) & (REPERES_FILE - 1);
+    return 1;
+}
+
+unsigned int reperes_nombre(unsigned char type) {
+    return (type < REPERE_NB) ? nombres[type] : 0;
+}
+
+void reperes_envoyer(void) {
+    unsigned char n;
+
+    uart_puts("reperes");
+    for (n = 0; n < REPERE_NB; n++) {
+        uart_putc(';');
+        uart_putu(nombres[n]);
+    }
+    uart_puts("\r\n");
+}
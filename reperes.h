@@ -0,0 +1,71 @@
+#ifndef REPERES_H
+#define REPERES_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Repères de la piste : croisements, marques latérales, trous
+//
+// CG et CD encadrent la ligne et en voient chacun une partie. A chaque
+// tic, le couple de mesures donne un motif :
+//   - ligne : cas normal, position = CD - CG utilisable ;
+//   - blanc : les deux capteurs pleins (param[PARAM_PLEIN]), une ligne
+//     traverse la piste ;
+//   - marque à droite : CD plein alors que CG voit encore la ligne (au
+//     dessus de param[PARAM_FOND]) ; dans un virage, CG quitterait la
+//     ligne. Marque à gauche : l'inverse ;
+//   - fond : aucun capteur ne voit la ligne.
+// Un motif compte après REPERES_CONFIRMATION tics identiques (parasites).
+// A la fin d'un motif, sa longueur parcourue (fronts de codeur) le classe :
+// croisement, marque ou trou s'il est assez court, rien sinon (ligne
+// large, vrai virage, ligne perdue que le suivi traite lui-même).
+//
+// Pendant un motif blanc ou marque, tant qu'il peut encore être un repère,
+// reperes_tic() renvoie 1 : la position mesurée est fausse, la commande
+// garde la dernière position valable au lieu de réagir.
+//
+// Chaque repère est daté et rangé dans une file (comptage des tours,
+// recalage de la carte), et compté par type pour le rapport de course.
+// Les longueurs sont à mesurer sur la piste.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "iut_temps.h"
+
+#define REPERES_CONFIRMATION    2       // tics
+#define REPERES_CROISEMENT_MAX  40      // fronts
+#define REPERES_MARQUE_MAX      40
+#define REPERES_TROU_MAX        150
+
+// Taille de la file (puissance de 2)
+#define REPERES_FILE    8
+
+// Types de repère
+#define REPERE_CROISEMENT   0
+#define REPERE_MARQUE_D     1
+#define REPERE_MARQUE_G     2
+#define REPERE_TROU         3
+#define REPERE_NB           4
+
+struct repere {
+    unsigned char type;
+    unsigned long date;         // début du motif (base de temps iut_temps)
+    unsigned long distance;     // fronts depuis le départ, début du motif
+    unsigned int longueur;      // fronts
+};
+
+// Au départ de la course (priorité haute) : compteurs à zéro ; la file
+// n'est vidée que par reperes_lire
+void reperes_depart(void);
+
+// A chaque tic de course, priorité haute ; renvoie 1 si la position
+// mesurée est à ignorer (croisement ou marque en cours)
+char reperes_tic(unsigned long date, int cg, int cd);
+
+// Retire le plus ancien repère de la file, renvoie 0 si elle est vide
+char reperes_lire(struct repere *r);
+
+// Repères d'un type depuis le départ
+unsigned int reperes_nombre(unsigned char type);
+
+// Envoie les compteurs : reperes;croisements;marques_d;marques_g;trous
+void reperes_envoyer(void);
+
+#endif
@@ -2,40 +2,807 @@
 #include "iut_lcd.h"
 #include "iut_adc.h"
 #include "iut_pwm.h"
-int potent = 0;
-int etatLectureCapteur = 0;
+#include "iut_profil.h"
+#include "iut_uart.h"
+#include "iut_banc.h"
+#include "iut_temps.h"
+#include "iut_it.h"
+#include "iut_taches.h"
+#include "iut_codeurs.h"
+#include "iut_hsm.h"
+#include "iut_usb_cdc.h"
+#include "entrees.h"
+#include "surveillance.h"
+#include "asservissement.h"
+#include "identification.h"
+#include "carte.h"
+#include "estimateur.h"
+#include "allure.h"
+#include "direction.h"
+#include "parametres.h"
+#include "capteurs.h"
+#include "reperes.h"
+#include "chrono.h"
+#include "telemetrie.h"
+#include "boite.h"
+#include "console.h"
+
+// étapes mesurées par le profilage (compilé avec -DPROFIL)
+#define ETAPE_BOUCLE    0   // un passage de l'ordonnanceur (taches_executer)
+#define ETAPE_SCAN      1   // du tic à la fin de conversion des canaux
+#define ETAPE_LCD_POS   2   // lcd_position
+#define ETAPE_LCD_PRINT 3   // lcd_printf
+#define ETAPE_SUIVI     4   // suiviLigne
+#define ETAPE_REPERES   5   // reperes_tic
+#define ETAPE_TELEM     6   // trame de télémétrie
+
+// Ligne perdue : CD et CG tous deux sous param[PARAM_FOND] (aucun ne voit
+// la ligne) pendant PERTE_CONFIRMATION boucles externes. Recherche du côté
+// où la ligne a été vue en dernier, RECHERCHE_MAX boucles au plus, puis
+// arrêt de la course.
+#define PERTE_CONFIRMATION  3
+#define RECHERCHE_MAX       (500 / ASSERV_DIVISEUR)     // 0,5 s
+
+// Tic de commande : 1 ms (en cycles instruction de 83,3 ns)
+#define TIC_PERIODE     12000
+
+// Liaison série : rapports, et trames à chaque tic avec -DTELEMETRIE
+// (sur l'USB avec -DUSB_CDC)
+#if defined(TELEMETRIE) && !defined(USB_CDC)
+#define UART_DEBIT      TELEM_DEBIT
+#else
+#define UART_DEBIT      115200
+#endif
+
+// Canaux convertis à chaque tic, dans l'ordre du scan
+// Les conversions se suivent à 25 us : CG est converti avant et après CD,
+// la moyenne des deux tombe à la date de CD et la position ne mélange pas
+// deux instants, même quand la ligne balaie vite les capteurs en virage
+#define RANG_POTENT     0
+#define RANG_CG         1
+#define RANG_CD         2
+#define RANG_CG_APRES   3
+#ifdef IR_MODULE
+// Emetteurs IR (RC0) éteints pendant la fin du scan : CG et CD sont
+// convertis émetteurs allumés puis éteints, à 100 us d'écart ; la
+// différence ne garde que la lumière réfléchie, l'éclairage ambiant et son
+// scintillement à 100 Hz s'annulent. La conversion du rang 4 est perdue,
+// le temps que les phototransistors se stabilisent émetteurs éteints.
+#define RANG_IR_ETEINT  3   // extinction après ce rang
+#define RANG_CG_ETEINT  5
+#define RANG_CD_ETEINT  6
+#define RANG_CG_ETEINT_APRES 7
+const char canaux[] = {0, 3, 1, 3, 3, 3, 1, 3};
+#else
+const char canaux[] = {0, 3, 1, 3};
+#endif
+
+// Machine de la course (iut_hsm.h), événements de entrees.h et EVT_ARRET
+// La tâche des états traite ARRET, FIN et IDENT, la commande MARCHE
+#define COURSE_ARRET    0
+#define COURSE_MARCHE   1
+#define COURSE_FIN      2
+#define COURSE_IDENT    3   // identification des moteurs (-DIDENTIFICATION)
+#define COURSE_REGLAGE  4   // menu de réglage, parent des 2 suivants
+#define COURSE_CHOIX    5   // le potentiomètre choisit le paramètre
+#define COURSE_VALEUR   6   // le potentiomètre règle sa valeur
+#define EVT_ARRET       5   // JCK, défaut ou ligne perdue
+#define NB_EVT_COURSE   6
+
+// Machine du suivi de ligne, traitée par la commande à chaque boucle
+// externe de la course
+#define SUIVI_LIGNE     0   // ligne vue, parent des 4 suivants
+#define SUIVI_DROIT     1
+#define SUIVI_DROITE    2
+#define SUIVI_GAUCHE    3
+#define SUIVI_TABLE     4   // direction par table (-DDIRECTION_TABLE)
+#define SUIVI_RECHERCHE 5   // ligne perdue, recherche
+#define SUIVI_PERDUE    6   // recherche sans succès
+// zone de la position prédite
+#define EVT_GAUCHE_FORT 0   // < seuil G
+#define EVT_GAUCHE      1   // < centre
+#define EVT_CENTRE      2   // = centre
+#define EVT_DROITE      3   // <= seuil D
+#define EVT_DROITE_FORT 4   // > seuil D
+#define EVT_FOND        5   // perte de la ligne confirmée
+#define EVT_VUE_DROITE  6   // ligne vue, à droite du centre
+#define EVT_VUE_GAUCHE  7
+#define EVT_DELAI       8   // fin du temps de recherche
+#define NB_EVT_SUIVI    9
+
+#ifdef DIRECTION_TABLE
+#define SUIVI_INITIAL   SUIVI_TABLE
+#define SUIVI_REPRISE_D SUIVI_TABLE
+#define SUIVI_REPRISE_G SUIVI_TABLE
+#else
+#define SUIVI_INITIAL   SUIVI_DROIT
+#define SUIVI_REPRISE_D SUIVI_DROITE
+#define SUIVI_REPRISE_G SUIVI_GAUCHE
+#endif
+
+extern struct hsm course, suivi;    // définies avec leurs tables
+volatile int ambiantMax = 0;    // plus forte lumière ambiante de la course
+char modeCourse = 0;        // 1 : aucun affichage pendant la course
+char modeIdent = 0;         // 1 : identification des moteurs (FDC au démarrage)
+// dates et durées en pas de la base de temps (0,667 us, iut_temps.h)
+unsigned long debutTour = 0;
+unsigned long instantEvenement = 0;     // date de l'événement traité
+volatile unsigned long dureeTour = 0;
+volatile unsigned char causeArret = 0;  // BOITE_xx, arrêt de la course
+volatile unsigned long nbBoucles = 0;   // commandes exécutées en course
+volatile unsigned long periodeMax = 0;  // plus long écart entre 2 commandes
+unsigned long instantCommande = 0;
+signed char virage = 0;     // pour la carte : +1 droite, -1 gauche
+unsigned char nbFond = 0;   // boucles externes sans voir la ligne
+unsigned char recherche = 0;    // boucles externes passées à la chercher
+char ligneADroite = 0;      // côté où la ligne a été vue en dernier
+volatile char lignePerdue = 0;  // recherche sans succès : fin de course
+volatile unsigned int nbRecuperations = 0;  // lignes retrouvées en course
+int differentiel = 0;       // consigne droite - gauche en cours, fronts/s
+int positionTenue = 0;      // dernière position hors croisement et marque
+unsigned int lignesCarte = 0;   // marques CHRONO_LIGNE passées à la carte
+// Mesures du tic, pour la commande ; hors priorité haute : capteurs_lire
     int CD, CG, position;
     //int setdc1, setdc2
+
+// Consignes des roues pour les rapports cycliques de référence rcDroit et
+// rcGauche, adaptées à la courbure et accélérées en ligne droite selon la
+// carte de la piste
+void consigneRoues(unsigned int rcDroit, unsigned int rcGauche) {
+    unsigned int f;
+    unsigned int droite, gauche;
+
+    f = (unsigned int) (((unsigned long) allure_facteur() * carte_facteur()) >> 8);
+    droite = (unsigned int) (((unsigned long) MOTEUR_VITESSE(rcDroit) * f) >> 8);
+    gauche = (unsigned int) (((unsigned long) MOTEUR_VITESSE(rcGauche) * f) >> 8);
+    differentiel = (int) droite - (int) gauche;
+    asserv_consigne(droite, gauche);
+}
+
+// Activités des états du suivi, à chaque boucle externe
+void allerDroit(void) {
+    virage = 0;
+    consigneRoues(param[PARAM_VITESSE], param[PARAM_VITESSE]);
+}
+
+void tournerDroite(void) {
+    virage = 1;
+    consigneRoues(param[PARAM_EXTERIEUR], param[PARAM_INTERIEUR]);
+}
+
+void tournerGauche(void) {
+    virage = -1;
+    consigneRoues(param[PARAM_INTERIEUR], param[PARAM_EXTERIEUR]);
+}
+
+void suivreTable(void) {
+    struct direction d;
+
+    direction_lire(estim_prediction(), param[PARAM_CENTRE],
+            param[PARAM_VITESSE], &d);
+    virage = (d.etat == 1) ? 1 : (d.etat == 2) ? -1 : 0;
+    consigneRoues(d.droit, d.gauche);
+}
+
+void chercher(void) {
+    if (++recherche > RECHERCHE_MAX) {
+        hsm_traiter(&suivi, EVT_DELAI);
+    } else if (ligneADroite) {
+        virage = 1;
+        consigneRoues(250, 50);     // moteur droit, moteur gauche
+    } else {
+        virage = -1;
+        consigneRoues(50, 250);
+    }
+}
+
+// Entrées et actions du suivi
+void commencerRecherche(void) {
+    recherche = 0;
+}
+
+void abandonner(void) {
+    lignePerdue = 1;
+}
+
+// ligne retrouvée : prédiction repartie de la mesure
+void reprendre(void) {
+    estim_init(position);
+    nbRecuperations++;
+}
+
+const struct hsm_etat etatsSuivi[] = {
+    {"ligne", HSM_AUCUN, 0, 0, 0},
+    {"droit", SUIVI_LIGNE, 0, 0, allerDroit},
+    {"droite", SUIVI_LIGNE, 0, 0, tournerDroite},
+    {"gauche", SUIVI_LIGNE, 0, 0, tournerGauche},
+    {"table", SUIVI_LIGNE, 0, 0, suivreTable},
+    {"recherche", HSM_AUCUN, commencerRecherche, 0, chercher},
+    {"perdue", HSM_AUCUN, abandonner, 0, 0},
+};
+
+#define RIEN    {HSM_AUCUN, 0}
+const struct hsm_transition transitionsSuivi[][NB_EVT_SUIVI] = {
+    // gauche fort, gauche, centre, droite, droite fort, fond, vue à
+    // droite, vue à gauche, délai
+    {RIEN, RIEN, RIEN, RIEN, RIEN, {SUIVI_RECHERCHE, 0}, RIEN, RIEN, RIEN},
+    {{SUIVI_GAUCHE, 0}, RIEN, RIEN, RIEN, {SUIVI_DROITE, 0}, RIEN, RIEN, RIEN, RIEN},
+    {{SUIVI_DROIT, 0}, {SUIVI_DROIT, 0}, RIEN, RIEN, RIEN, RIEN, RIEN, RIEN, RIEN},
+    {RIEN, RIEN, RIEN, {SUIVI_DROIT, 0}, {SUIVI_DROIT, 0}, RIEN, RIEN, RIEN, RIEN},
+    {RIEN, RIEN, RIEN, RIEN, RIEN, RIEN, RIEN, RIEN, RIEN},
+    {RIEN, RIEN, RIEN, RIEN, RIEN, RIEN, {SUIVI_REPRISE_D, reprendre},
+            {SUIVI_REPRISE_G, reprendre}, {SUIVI_PERDUE, 0}},
+    {RIEN, RIEN, RIEN, RIEN, RIEN, RIEN, RIEN, RIEN, RIEN},
+};
+
+struct hsm suivi = {"suivi", etatsSuivi, transitionsSuivi[0], NB_EVT_SUIVI};
+
+unsigned char zone(int p) {
+    if (p < param[PARAM_SEUIL_G]) return EVT_GAUCHE_FORT;
+    if (p < param[PARAM_CENTRE]) return EVT_GAUCHE;
+    if (p == param[PARAM_CENTRE]) return EVT_CENTRE;
+    if (p <= param[PARAM_SEUIL_D]) return EVT_DROITE;
+    return EVT_DROITE_FORT;
+}
+
+// Un événement par boucle externe : perte de la ligne confirmée, ligne
+// revue (traité en recherche seulement) ou zone de la position prédite au
+// moment où la consigne agira ; puis activité de l'état
 void suiviLigne(void) {
-    switch (etatLectureCapteur) {
-        case 0:                     // tout droit
-           //if ((CD < 900)&(CG < 200)) etatLectureCapteur = 1;
-            if (position > -142) etatLectureCapteur = 1;  // tourne à droite
-            //if ((CG < 900)&(CD < 200)) etatLectureCapteur = 2;
-            if (position <-292) etatLectureCapteur = 2;  // tourne à gauche
-            pwm_setdc1(150); // moteur droit
-            pwm_setdc2(150); // moteur gauche
-            break
-        case 1:                    // tourner à droite
-            if (position < -217) etatLectureCapteur = 0;
-                pwm_setdc1(200); // moteur droit
-                pwm_setdc2(100); // moteur gauche  
+    allure_calculer(position, differentiel);
+    if (CD < param[PARAM_FOND] && CG < param[PARAM_FOND]) {
+        if (nbFond < PERTE_CONFIRMATION) nbFond++;
+    } else {
+        // position à droite du centre : la ligne est à droite du robot
+        nbFond = 0;
+        ligneADroite = (position > param[PARAM_CENTRE]);
+    }
+
+    if (nbFond == PERTE_CONFIRMATION) {
+        hsm_traiter(&suivi, EVT_FOND);
+    } else if (nbFond != 0 || !hsm_traiter(&suivi,
+            ligneADroite ? EVT_VUE_DROITE : EVT_VUE_GAUCHE)) {
+        hsm_traiter(&suivi, zone(estim_prediction()));
+    }
+    hsm_activite(&suivi);
+}
+
+#ifdef LCD_MESURE
+// Envoi de l'attente due au LCD (en cycles instruction) et de l'écran
+void envoyerMesureLcd(void) {
+    struct lcd_mesure m;
+
+    lcd_mesure_lire(&m);
+    uart_puts("lcd_printf;");
+    uart_putu(m.nb_printf);
+    uart_putc(';');
+    uart_putu(8UL * m.printf_derniere);
+    uart_putc(';');
+    uart_putu(8UL * m.printf_max);
+    uart_putc(';');
+    uart_putu(m.nb_printf ? 8UL * (m.printf_somme / m.nb_printf) : 0);
+    uart_puts("\r\nlcd_total;");
+    uart_putu(8UL * m.totale);
+    uart_puts("\r\necran;");
+    uart_puts(lcd_ecran(0));
+    uart_puts("\r\necran;");
+    uart_puts(lcd_ecran(1));
+    uart_puts("\r\n");
+}
+#endif
+
+// Tic de commande, priorité haute : entrées puis lancement du scan ADC
+void tic(void) {
+    surveillance_tic();
+    taches_tic();
+    entrees_scruter();
+    PROFIL_DEBUT(ETAPE_SCAN);
+    adc_scan_lancer();
+}
+
+#ifdef IR_MODULE
+// Au milieu du scan, priorité haute
+void eteindreIR(void) {
+    LATCbits.LATC0 = 0;
+}
+
+// Lumière réfléchie : mesure émetteurs allumés moins émetteurs éteints
+int mesurerIR(int allume, int eteint) {
+    // maximum de la course, lu par la tâche des états après la course
+    if (hsm_etat(&course) == COURSE_MARCHE && eteint > ambiantMax) {
+        ambiantMax = eteint;
+    }
+    return (allume > eteint) ? allume - eteint : 0;
+}
+#endif
+
+#ifdef TELEMETRIE
+// Trame du tic de course, après le calcul des rapports cycliques
+void envoyerTelemetrie(void) {
+    struct telem_mesure m;
+
+    m.tic = (unsigned int) nbBoucles;
+    m.cd = CD;
+    m.cg = CG;
+    m.position = position;
+    m.rc_droit = asserv_rc(CODEUR_DROIT);
+    m.rc_gauche = asserv_rc(CODEUR_GAUCHE);
+    m.etat = (unsigned char) ((hsm_etat(&course) << 4) | hsm_etat(&suivi));
+    telem_envoyer(&m);
+}
+#endif
+
+// CG à la date de CD : moyenne des conversions qui l'encadrent
+int moyenneCG(unsigned char avant, unsigned char apres) {
+    return (adc_scan_valeur(avant) + adc_scan_valeur(apres) + 1) >> 1;
+}
+
+// Fin du scan ADC, priorité haute : mesures puis commande des moteurs
+void commande(void) {
+    unsigned long instant;
+
+    PROFIL_FIN(ETAPE_SCAN);
+#ifdef IR_MODULE
+    CG = mesurerIR(moyenneCG(RANG_CG, RANG_CG_APRES),
+            moyenneCG(RANG_CG_ETEINT, RANG_CG_ETEINT_APRES));
+    CD = mesurerIR(adc_scan_valeur(RANG_CD), adc_scan_valeur(RANG_CD_ETEINT));
+    LATCbits.LATC0 = 1;     // rallumés jusqu'au scan suivant
+#else
+    CG = moyenneCG(RANG_CG, RANG_CG_APRES);
+    CD = adc_scan_valeur(RANG_CD);
+#endif
+    position = CD - CG;     // positif si sortie vers la gauche
+                            // négatif si sortie vers la droite
+    codeurs_mesurer();
+    instant = temps_lire();
+    capteurs_publier(instant, adc_scan_valeur(RANG_POTENT), CG, CD);
+    // JCK scruté par ce même tic : arrêt sans attendre la boucle principale
+    // (JCK déjà à 0 au départ : pas de front, arrêt sur le niveau)
+    // défaut d'échéance : les moteurs restent arrêtés
+    // ligne perdue et pas retrouvée : fin de course
+    if (hsm_etat(&course) == COURSE_MARCHE
+            && (entrees_jck() == 0 || surveillance_arret() || lignePerdue)) {
+        dureeTour = instant - debutTour;
+        causeArret = lignePerdue ? BOITE_PERDUE
+                : surveillance_arret() ? BOITE_DEFAUT : BOITE_JCK;
+        boite_figer(causeArret, (unsigned int) nbBoucles);
+        hsm_traiter(&course, EVT_ARRET);
+    }
+    switch (hsm_etat(&course)) {
+#ifdef IDENTIFICATION
+        case COURSE_IDENT:
+            // essai d'identification : il pilote seul les moteurs, sauf
+            // après un défaut, qui les garde arrêtés
+            if (!surveillance_arret()) identification_tic();
             break;
-        case 2:                     // tourner à gauche
-            if (position > -217) etatLectureCapteur = 0;
-               pwm_setdc1(100); //moteur droit
-               pwm_setdc2(200); //moteur gauche
+#endif
+        case COURSE_MARCHE:
+            if (instant - instantCommande > periodeMax) {
+                periodeMax = instant - instantCommande;
+            }
+            // carte : apprise au premier tour, suivie aux suivants
+            if (nbBoucles == 0) {
+                carte_depart();
+                estim_init(position);
+                allure_init();
+                direction_init();
+                differentiel = 0;
+                virage = 0;
+                hsm_init(&suivi, SUIVI_INITIAL);
+                reperes_depart();
+                lignesCarte = 0;
+                boite_depart();
+                positionTenue = position;
+            }
+            // croisement ou marque : CD - CG ne dit rien de la ligne, la
+            // direction continue sur la dernière position valable
+            PROFIL_DEBUT(ETAPE_REPERES);
+            if (reperes_tic(instant, CG, CD)) {
+                position = positionTenue;
+            } else {
+                positionTenue = position;
+            }
+            // marque de départ et d'arrivée : fin de l'apprentissage, puis
+            // recalage de la carte à chaque tour
+            if (reperes_nombre(CHRONO_LIGNE) != lignesCarte) {
+                lignesCarte = reperes_nombre(CHRONO_LIGNE);
+                carte_ligne();
+            }
+            PROFIL_FIN(ETAPE_REPERES);
+            estim_mettre_a_jour(position, differentiel);
+            carte_tic(virage);
+            // boucle externe : consignes de vitesse des roues
+            if (nbBoucles % ASSERV_DIVISEUR == 0) {
+                PROFIL_DEBUT(ETAPE_SUIVI);
+                suiviLigne();
+                PROFIL_FIN(ETAPE_SUIVI);
+                // recherche : la boîte garde la sortie de la ligne
+                if (hsm_etat(&suivi) == SUIVI_RECHERCHE
+                        || hsm_etat(&suivi) == SUIVI_PERDUE) {
+                    boite_interrompre();
+                } else {
+                    boite_echantillon((unsigned int) nbBoucles, position,
+                            hsm_etat(&suivi), nbFond != 0, differentiel);
+                }
+            }
+            nbBoucles++;
+            // boucle interne : vitesse des roues, à chaque tic
+            asserv_calculer();
+#ifdef TELEMETRIE
+            PROFIL_DEBUT(ETAPE_TELEM);
+            envoyerTelemetrie();
+            PROFIL_FIN(ETAPE_TELEM);
+#endif
             break;
-            
         default:
-            // ce cas ne devrait jamais se produire
-            etatLectureCapteur = 0;
-    } // fin du switch*
+            // arrêt et fin de course : moteurs arrêtés
+            asserv_arreter();
+    }
+    instantCommande = instant;
+    surveillance_commande();
 }
+
+// Bilan de la dernière course : durée et fréquence de la commande
+//   ligne 0 - mode  durée en s
+//   ligne 1 - fréquence moyenne et minimale de la commande en Hz
+void afficherBilan(void) {
+    unsigned long dureeMs;
+    unsigned int freq = 0, freqMin = 0;
+
+    dureeMs = dureeTour / TEMPS_PAR_MS;
+    if (dureeMs) freq = nbBoucles * 1000 / dureeMs;
+    if (periodeMax) freqMin = TEMPS_PAR_S / periodeMax;
+    lcd_position(0, 0);
+    lcd_printf("%-6S%4u.%02u s",
+            lignePerdue ? "perdue" : modeCourse ? "course" : "debug",
+            (unsigned int) (dureeMs / 1000),
+            (unsigned int) ((dureeMs % 1000) / 10));
+    lcd_position(1, 0);
+    lcd_printf("Hz%6u mn%5u", freq, freqMin);
+}
+
+// Chronométrage, record en EEPROM
+//   ligne 0 - dernier tour en s et ms, moyenne en s et 1/100 s
+//   ligne 1 - meilleur tour, nombre de tours du record
+void afficherChrono(void) {
+    unsigned long dernier = chronoRecord.dernier / 1000;    // ms
+    unsigned long meilleur = chronoRecord.meilleur / 1000;
+    unsigned long moyenne = chrono_moyenne();
+
+    lcd_position(0, 0);
+    if (chronoRecord.nombre == 0) {
+        lcd_printf("aucun tour      ");
+        lcd_position(1, 0);
+        lcd_printf("                ");
+        return;
+    }
+    lcd_printf("d%3u.%03u m%3u.%02u",
+            (unsigned int) (dernier / 1000), (unsigned int) (dernier % 1000),
+            (unsigned int) (moyenne / 1000),
+            (unsigned int) ((moyenne % 1000) / 10));
+    lcd_position(1, 0);
+    lcd_printf("min%3u.%03u t%4u",
+            (unsigned int) (meilleur / 1000), (unsigned int) (meilleur % 1000),
+            chronoRecord.nombre);
+}
+
+// Cause de l'arrêt forcé, conservée après le reset du chien de garde
+//   ligne 0 - cause
+//   ligne 1 - durée mesurée en us
+void afficherDefaut(void) {
+    struct defaut d;
+    const char *nom;
+
+    switch (surveillance_defaut(&d)) {
+        case SURV_ECHEANCE_DEPASSEE:
+            nom = "echeance";
+            break;
+        case SURV_TIC_EN_RETARD:
+            nom = "tic lent";
+            break;
+        case SURV_COMMANDE_MANQUEE:
+            nom = "manquee";
+            break;
+        default:
+            nom = "chien";
+    }
+    lcd_position(0, 0);
+    lcd_printf("defaut %-8S", nom);
+    lcd_position(1, 0);
+    lcd_printf("%8u us     ", (unsigned int) (2UL * d.valeur / 3));
+}
+
+#ifdef IDENTIFICATION
+// Mode identification : état de l'essai puis modèle de chaque roue
+//   ligne 0 - roue droite  : gain (fronts/s par rc), constante de temps
+//             et retard en ms
+//   ligne 1 - roue gauche
+void afficherIdentification(void) {
+    struct modele m;
+    unsigned char r;
+
+    if (identification_etat() != IDENT_FINI) {
+        lcd_position(0, 0);
+        lcd_printf("identification  ");
+        lcd_position(1, 0);
+        lcd_printf(identification_etat() == IDENT_EN_COURS
+                ? "essai en cours  " : "FDC : lancer    ");
+        return;
+    }
+    for (r = 0; r < 2; r++) {
+        lcd_position(r, 0);
+        if (identification_modele(r, &m)) {
+            lcd_printf("%cK%4uT%4uL%3u", r == CODEUR_DROIT ? 'd' : 'g',
+                    m.gain_q8 >> 8, m.tau_ms, m.retard_ms);
+        } else {
+            lcd_printf("%c pas de reponse", r == CODEUR_DROIT ? 'd' : 'g');
+        }
+    }
+}
+#endif
+
+// Entrées et actions de la course
+// la commande ne touche à rien avant la fin de l'entrée dans MARCHE
+void demarrerCourse(void) {
+    nbFond = 0;
+    lignePerdue = 0;
+    nbRecuperations = 0;
+    ambiantMax = 0;
+    debutTour = instantEvenement;
+    nbBoucles = 0;
+    periodeMax = 0;
+    PROFIL_EFFACER(); // mesures de la course seulement
+#ifdef LCD_MESURE
+    lcd_mesure_effacer();
+#endif
+    chrono_depart(instantEvenement);
+#ifdef TELEMETRIE
+    telem_depart();
+#endif
+    it_latence_effacer();
+    taches_effacer();
+    surveillance_effacer();
+#ifdef HSM_TRACE
+    hsm_trace_effacer();
+#endif
+}
+
+// Depuis la commande, priorité haute ; piste sans repère (trous
+// exceptés) arrêtée par JCK : la course entière fait un tour, comme pour
+// le chronométrage
+void terminerCourse(void) {
+    carte_fin(causeArret == BOITE_JCK
+            && reperes_nombre(REPERE_CROISEMENT) == 0
+            && reperes_nombre(REPERE_MARQUE_D) == 0
+            && reperes_nombre(REPERE_MARQUE_G) == 0);
+}
+
+void envoyerRapport(void) {
+#ifdef TELEMETRIE
+    telem_attendre();   // fin des trames de la course
+#endif
+    PROFIL_ENVOYER(); // moteurs arrêtés, l'envoi peut durer
+#ifdef PROFIL
+    uart_puts("latence_tic;");
+    uart_putu(it_latence_max()); // en cycles instruction
+    uart_puts("\r\n");
+    taches_envoyer();
+    surveillance_envoyer();
+    uart_puts("recuperations;");
+    uart_putu(nbRecuperations);
+    uart_putc(';');
+    uart_putu(lignePerdue);
+    uart_puts("\r\n");
+    carte_envoyer();
+    reperes_envoyer();
+    chrono_envoyer();
+    boite_envoyer();
+#ifdef TELEMETRIE
+    telem_envoyer_bilan();
+#endif
+#ifdef IR_MODULE
+    uart_puts("ambiant;");
+    uart_putu(ambiantMax);
+    uart_puts("\r\n");
+#endif
+#endif
+#ifdef HSM_TRACE
+    hsm_trace_envoyer();
+#endif
+#ifdef LCD_MESURE
+    envoyerMesureLcd();
+#endif
+}
+
+// Retour à l'arrêt, repères de la course déjà lus par la tâche des
+// états : tours ajoutés au record en EEPROM, puis rapport ; une course
+// abandonnée (ligne perdue, défaut) ne compte pas pour un tour
+void rangerCourse(void) {
+    chrono_fin(dureeTour, causeArret == BOITE_JCK);
+    envoyerRapport();
+}
+
+// Menu de réglage, à l'arrêt : JCK à 0 pour entrer, à 1 pour sortir en
+// enregistrant ; le potentiomètre choisit le paramètre, FDC passe au
+// réglage de sa valeur, le potentiomètre la règle, FDC la valide
+unsigned char rangReglage;  // paramètre en cours de réglage
+char reglageModifie;
+
+// Potentiomètre du dernier tic
+int lirePotent(void) {
+    struct capteurs c;
+
+    capteurs_lire(&c);
+    return c.potent;
+}
+
+// Paramètre désigné par le potentiomètre
+unsigned char rangPotent(void) {
+    return (unsigned char) (((unsigned long) lirePotent() * PARAM_NB) >> 10);
+}
+
+// Valeur désignée par le potentiomètre, entre les bornes du paramètre
+int valeurPotent(void) {
+    const struct parametre *t = &parametresTable[rangReglage];
+
+    return t->min + (int) ((long) (t->max - t->min) * lirePotent() / 1023);
+}
+
+void entrerReglage(void) {
+    reglageModifie = 0;
+}
+
+void quitterReglage(void) {
+    if (!reglageModifie) return;
+    parametres_sauver();
+    asserv_gains(param[PARAM_KP], param[PARAM_KI]);
+}
+
+void choisirParametre(void) {
+    rangReglage = rangPotent();
+}
+
+void validerValeur(void) {
+    param[rangReglage] = valeurPotent();
+    reglageModifie = 1;
+}
+
+const struct hsm_etat etatsCourse[] = {
+    {"arret", HSM_AUCUN, 0, 0, 0},
+    {"marche", HSM_AUCUN, demarrerCourse, 0, 0},
+    {"fin", HSM_AUCUN, terminerCourse, 0, 0},
+    {"ident", HSM_AUCUN, 0, 0, 0},
+    {"reglage", HSM_AUCUN, entrerReglage, quitterReglage, 0},
+    {"choix", COURSE_REGLAGE, 0, 0, 0},
+    {"valeur", COURSE_REGLAGE, choisirParametre, 0, 0},
+};
+
+const struct hsm_transition transitionsCourse[][NB_EVT_COURSE] = {
+    // -, FDC haut, FDC bas, JCK haut, JCK bas, arrêt
+    {RIEN, {COURSE_MARCHE, 0}, RIEN, RIEN, {COURSE_CHOIX, 0}, RIEN},
+    {RIEN, RIEN, RIEN, RIEN, RIEN, {COURSE_FIN, 0}},
+    {RIEN, RIEN, {COURSE_ARRET, rangerCourse}, RIEN, RIEN, RIEN},
+#ifdef IDENTIFICATION
+    // pas de course en mode identification : FDC lance l'essai
+    {RIEN, {HSM_INTERNE, identification_lancer}, RIEN, RIEN, RIEN, RIEN},
+#else
+    {RIEN, RIEN, RIEN, RIEN, RIEN, RIEN},   // état jamais atteint
+#endif
+    {RIEN, RIEN, RIEN, {COURSE_ARRET, 0}, RIEN, RIEN},
+    {RIEN, {COURSE_VALEUR, 0}, RIEN, RIEN, RIEN, RIEN},
+    {RIEN, {COURSE_CHOIX, validerValeur}, RIEN, RIEN, RIEN, RIEN},
+};
+
+struct hsm course = {"course", etatsCourse, transitionsCourse[0], NB_EVT_COURSE};
+
+// Menu de réglage
+//   ligne 0 - nom et valeur en service du paramètre
+//   ligne 1 - choix : aide ; réglage : nouvelle valeur
+void afficherReglage(void) {
+    unsigned char n;
+
+    n = (hsm_etat(&course) == COURSE_CHOIX) ? rangPotent() : rangReglage;
+    lcd_position(0, 0);
+    lcd_printf("%-10S%6d", parametresTable[n].nom, param[n]);
+    lcd_position(1, 0);
+    if (hsm_etat(&course) == COURSE_CHOIX) {
+        lcd_printf("FDC:modif JCK:ok");
+    } else {
+        lcd_printf("->%6d  FDC:ok", valeurPotent());
+    }
+}
+
+// Repères de la piste pour le chronométrage, puis changements d'état sur
+// événement, datés par l'interruption, et sur le niveau de FDC en FIN
+char tacheEtats(struct pt *pt) {
+    struct evenement evt;
+    struct repere r;
+
+    PT_DEBUT(pt);
+    while (reperes_lire(&r)) {
+        chrono_repere(&r);
+    }
+    while (entrees_lire(&evt)) {
+        instantEvenement = evt.instant;
+        hsm_traiter(&course, evt.type);
+    }
+    // FDC relâché pendant la course : son front, sans effet en MARCHE, est
+    // perdu, retour à l'arrêt sur le niveau (comme JCK au départ)
+    if (hsm_etat(&course) == COURSE_FIN && entrees_fdc() == 0) {
+        instantEvenement = temps_lire();
+        hsm_traiter(&course, EVT_FDC_BAS);
+    }
+    PT_FIN(pt);
+}
+
+// Affichage, une ligne du LCD par pas : l'écriture d'une ligne dure
+// plusieurs ms, la tâche des états passe entre les deux
+char tacheAffichage(struct pt *pt) {
+    static struct capteurs c;   // les 2 lignes affichent le même tic
+
+    PT_DEBUT(pt);
+#ifdef PROFIL
+    if (hsm_etat(&course) == COURSE_FIN) {
+        // fin de course : le potentiomètre choisit l'étape affichée
+        PROFIL_AFFICHER(lirePotent() / (1024 / PROFIL_NB_ETAPES));
+    } else
+#endif
+    if (hsm_etat(&course) == COURSE_CHOIX
+            || hsm_etat(&course) == COURSE_VALEUR) {
+        afficherReglage();
+    } else if (hsm_etat(&course) == COURSE_ARRET && surveillance_arret()) {
+        afficherDefaut();
+#ifdef IDENTIFICATION
+    } else if (hsm_etat(&course) == COURSE_IDENT) {
+        afficherIdentification();
+#endif
+    } else if (hsm_etat(&course) == COURSE_ARRET && lirePotent() >= 512) {
+        afficherChrono();   // potentiomètre au-delà de la moitié, tout mode
+    } else if (hsm_etat(&course) == COURSE_FIN
+            || (modeCourse && hsm_etat(&course) == COURSE_ARRET)) {
+        afficherBilan();
+    } else if (!modeCourse) {
+        capteurs_lire(&c);
+        PROFIL_DEBUT(ETAPE_LCD_POS);
+        lcd_position(0, 0);
+        PROFIL_FIN(ETAPE_LCD_POS);
+        PROFIL_DEBUT(ETAPE_LCD_PRINT);
+        lcd_printf(" Pos %4d  ", c.position);
+        PROFIL_FIN(ETAPE_LCD_PRINT);
+        PT_CEDER(pt);
+        PROFIL_DEBUT(ETAPE_LCD_POS);
+        lcd_position(1, 0);
+        PROFIL_FIN(ETAPE_LCD_POS);
+        PROFIL_DEBUT(ETAPE_LCD_PRINT);
+        lcd_printf("CD%4d CG%4d", c.cd, c.cg);
+        PROFIL_FIN(ETAPE_LCD_PRINT);
+    }
+    PT_FIN(pt);
+}
+
+#ifdef USB_CDC
+// Paramètres modifiables depuis le PC à l'arrêt seulement, hors du menu
+char consoleReglable(void) {
+    return hsm_etat(&course) == COURSE_ARRET;
+}
+#endif
+
+// Tâches de fond, par ordre de priorité (périodes et échéances en tics) ;
+// une tâche qui attend (EEPROM, place USB, relevé) laisse passer les
+// suivantes
+const struct tache taches[] = {
+    {"etats", tacheEtats, 1, 2},                // à chaque tic
+    {"affichage", tacheAffichage, 100, 100},    // 10 Hz
+    {"boite", boite_ecrire, 10, 1000},          // copie en 0,5 s environ
+#ifdef USB_CDC
+    {"console", console_servir, 10, 100},       // commandes du PC
+#endif
+#ifdef IDENTIFICATION
+    {"ident", identification_envoyer, 10, 1000}, // relevé, une ligne par pas
+#endif
+};
+
 void main(void) {
-    // declarations des variables
-    char JCK, FDC;
-    int etat;
     // initialisation    
     lcd_init();
     lcd_position(0, 0);
@@ -45,49 +812,73 @@ void main(void) {
     pwm_setdc2(0); // 0,75 pour PWM2 (broche C1)
     TRISB = 0xFF;
     TRISE = 0xFF;
+#ifdef IDENTIFICATION
+    // FDC appuyé à la mise sous tension : identification des moteurs
+    modeIdent = PORTBbits.RB2;
+#endif
+#if defined(PROFIL) || defined(BANC_ESSAI) || defined(LCD_MESURE) \
+        || defined(TELEMETRIE) || defined(HSM_TRACE)
+    uart_init(UART_DEBIT);
+#elif defined(IDENTIFICATION)
+    if (modeIdent) uart_init(UART_DEBIT);  // envoi du relevé
+#endif
+#ifdef BANC_ESSAI
+    banc_essai(); // rapport des durées des fonctions de la bibliothèque
+#endif
+    PROFIL_INIT();
+    PROFIL_NOMMER(ETAPE_BOUCLE, "boucle");
+    PROFIL_NOMMER(ETAPE_SCAN, "scan");
+    PROFIL_NOMMER(ETAPE_LCD_POS, "lcd_pos");
+    PROFIL_NOMMER(ETAPE_LCD_PRINT, "printf");
+    PROFIL_NOMMER(ETAPE_SUIVI, "suivi");
+    PROFIL_NOMMER(ETAPE_REPERES, "reperes");
+    PROFIL_NOMMER(ETAPE_TELEM, "telem");
+    // choix du mode au démarrage : potentiomètre au-delà de la moitié
+    // => mode course, l'écran n'est pas rafraîchi pendant la course
+    modeCourse = (adc_read(0) >= 512);
+    // priorité haute : base de temps, codeurs, scan ADC et tic de
+    // commande ; la base de temps en premier, lue par toutes les autres :
+    // en priorité basse, une routine haute passant entre l'effacement de
+    // TMR1IF et l'incrément lirait une date fausse de 43,7 ms
+    // priorité basse : FDC (INT2), puis les liaisons
+    it_init();
+    temps_init();
+    boite_init();       // avant surveillance_init, qui réarme nPOR
+    surveillance_init();
+    it_enregistrer(IT_TMR1, IT_HAUTE, temps_it);
+    entrees_init();
+    it_enregistrer(IT_INT2, IT_BASSE, entrees_it);
+#ifdef TELEMETRIE
+    telem_init();       // émission série en dernier, priorité basse
+#endif
+#ifdef USB_CDC
+    usb_cdc_init();     // port série virtuel, priorité basse
+    console_init(consoleReglable);
+#endif
+    codeurs_init();     // INT0 et INT1 en priorité haute
+    asserv_init();
+    parametres_charger();
+    chrono_charger();
+    asserv_gains(param[PARAM_KP], param[PARAM_KI]);
+    carte_init();
+    adc_scan_init(canaux, sizeof(canaux), commande);
+#ifdef IR_MODULE
+    TRISCbits.TRISC0 = 0;
+    LATCbits.LATC0 = 1;
+    adc_scan_etape(RANG_IR_ETEINT, eteindreIR);
+#endif
+    it_enregistrer(IT_AD, IT_HAUTE, adc_scan_it);
+    it_tic_init(TIC_PERIODE, tic);
+    taches_init(taches, sizeof(taches) / sizeof(taches[0]));
+    hsm_init(&course, modeIdent ? COURSE_IDENT : COURSE_ARRET);
+    it_autoriser();
+    surveillance_demarrer();
+    // la commande est sous interruption, la boucle principale ne fait plus
+    // qu'exécuter les tâches de fond dans le temps restant
     while (1) {
-        // initialisation    
-        //lcd_position(0, 0);
-        // acquisition entrée
-        potent = adc_read(0);
-        FDC = PORTBbits.RB2;
-        JCK = PORTEbits.RE2;
-        // lecture des capteurs
-        CG = adc_read(3);
-        CD = adc_read(1);
-        position = CD - CG;     // positif si sortie vers la gauche
-                                // négatif si sortie vers la droite
-        // affichage
-        lcd_position(0, 0);
-        lcd_printf(" Pos %4d  ", position);
-        lcd_position(1, 0);
-        lcd_printf("CD%4d CG%4d", CD, CG);
-        switch (etat) {
-            case 0:                 // arret des moteurs
-                //lcd_position(0, 0);
-                pwm_setdc1(0);
-                pwm_setdc2(0);
-                if (FDC != 0) {
-                    etat = 1;
-                    etatLectureCapteur = 0;
-                }
-                break;  
-            case 1:                 // course
-                if (JCK == 0) etat = 2;
-               // lcd_position(0, 0);
-               // lcd_printf("Etat = 1");
-                suiviLigne();
-                break;
-            case 2:                 // fin de course
-                pwm_setdc1(0); // 0,25 pour PWM1 (broche C2)
-                pwm_setdc2(0); // 0,75 pour PWM2 (broche C1)
-
-                if (FDC == 0) etat = 0;
-                //lcd_position(0, 0);
-                //lcd_printf("Etat = 0");
-                break;
-            default:
-                // ce cas ne devrait jamais se produire
-                etat = 0    }   
- }  
+        PROFIL_FIN(ETAPE_BOUCLE);
+        PROFIL_DEBUT(ETAPE_BOUCLE);
+        taches_executer();
+        surveillance_servir();
+    }
 }
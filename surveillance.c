@@ -0,0 +1,157 @@
+#include <xc.h>
+#include "iut_temps.h"
+#include "iut_pwm.h"
+#include "iut_uart.h"
+#include "surveillance.h"
+
+// Origine des classes de l'écart entre tics : la période nominale tombe
+// au milieu de l'histogramme
+#define ORIGINE_TIC (SURV_PERIODE - ((SURV_NB_CLASSES / 2) << SURV_DECALAGE_TIC))
+
+static struct histogramme histoTic, histoCommande;
+
+// Conservé par un reset du chien de garde (pas effacé au démarrage)
+static persistent struct defaut defautMemorise;
+
+static unsigned long instantTic;
+static char ticValide = 0;      // instantTic date un tic précédent
+static volatile char commandeFaite = 1;
+static volatile char commandeVue = 0;   // depuis le dernier service
+// Défaut signalé depuis le démarrage : le chien de garde n'est plus servi
+// jusqu'au reset. Un défaut relu après le reset reste mémorisé (moteurs
+// arrêtés) mais n'empêche plus le service : un seul reset par défaut.
+static volatile char defautEnCours = 0;
+
+static void classer(struct histogramme *h, unsigned long duree,
+        unsigned int origine, unsigned char decalage) {
+    unsigned int d, c;
+
+    d = (duree > 0xFFFF) ? 0xFFFF : (unsigned int) duree;
+    if (d > h->max) h->max = d;
+    c = (d < origine) ? 0 : (d - origine) >> decalage;
+    if (c >= SURV_NB_CLASSES) c = SURV_NB_CLASSES - 1;
+    if (h->classe[c] != 0xFFFF) h->classe[c]++;
+}
+
+// Premier défaut seulement : moteurs arrêtés, cause mémorisée
+static void signaler(unsigned char cause, unsigned long duree) {
+    if (defautMemorise.cause != SURV_AUCUN) return;
+    pwm_setdc1(0);
+    pwm_setdc2(0);
+    defautMemorise.cause = cause;
+    defautMemorise.valeur = (duree > 0xFFFF) ? 0xFFFF : (unsigned int) duree;
+    defautEnCours = 1;
+}
+
+void surveillance_init(void) {
+    if (!RCONbits.nPOR) {
+        // mise sous tension : le contenu de la RAM est quelconque
+        defautMemorise.cause = SURV_AUCUN;
+        defautMemorise.valeur = 0;
+        RCONbits.nPOR = 1;
+    } else if (!RCONbits.nTO && defautMemorise.cause == SURV_AUCUN) {
+        // reset du chien de garde sans défaut de la commande
+        defautMemorise.cause = SURV_CHIEN_DE_GARDE;
+        defautMemorise.valeur = 0;
+    }
+    CLRWDT();   // remet nTO à 1
+}
+
+void surveillance_demarrer(void) {
+    CLRWDT();
+    WDTCONbits.SWDTEN = 1;
+}
+
+void surveillance_tic(void) {
+    unsigned long t = temps_lire();
+
+    if (ticValide) {
+        classer(&histoTic, t - instantTic, ORIGINE_TIC, SURV_DECALAGE_TIC);
+        if (t - instantTic > SURV_PERIODE + SURV_RETARD) {
+            signaler(SURV_TIC_EN_RETARD, t - instantTic);
+        }
+        if (!commandeFaite) signaler(SURV_COMMANDE_MANQUEE, t - instantTic);
+    }
+    instantTic = t;
+    ticValide = 1;
+    commandeFaite = 0;
+}
+
+void surveillance_commande(void) {
+    unsigned long duree = temps_lire() - instantTic;
+
+    classer(&histoCommande, duree, 0, SURV_DECALAGE_CMD);
+    commandeFaite = 1;
+    if (duree > SURV_ECHEANCE) {
+        signaler(SURV_ECHEANCE_DEPASSEE, duree);
+    } else {
+        commandeVue = 1;
+    }
+}
+
+void surveillance_servir(void) {
+    if (commandeVue && !defautEnCours) {
+        commandeVue = 0;
+        CLRWDT();
+    }
+}
+
+char surveillance_arret(void) {
+    return defautMemorise.cause != SURV_AUCUN;
+}
+
+unsigned char surveillance_defaut(struct defaut *d) {
+    INTCONbits.GIEH = 0;
+    *d = defautMemorise;
+    INTCONbits.GIEH = 1;
+    return d->cause;
+}
+
+void surveillance_effacer(void) {
+    unsigned char c;
+
+    INTCONbits.GIEH = 0;
+    for (c = 0; c < SURV_NB_CLASSES; c++) {
+        histoTic.classe[c] = 0;
+        histoCommande.classe[c] = 0;
+    }
+    histoTic.max = 0;
+    histoCommande.max = 0;
+    defautMemorise.cause = SURV_AUCUN;
+    defautMemorise.valeur = 0;
+    defautEnCours = 0;
+    INTCONbits.GIEH = 1;
+}
+
+static void envoyerHistogramme(const char *nom, struct histogramme *h) {
+    unsigned char c;
+
+    uart_puts(nom);
+    for (c = 0; c < SURV_NB_CLASSES; c++) {
+        uart_putc(';');
+        uart_putu(h->classe[c]);
+    }
+    uart_putc(';');
+    uart_putu(h->max);
+    uart_puts("\r\n");
+}
+
+void surveillance_envoyer(void) {
+    struct histogramme h;
+    struct defaut d;
+
+    INTCONbits.GIEH = 0;
+    h = histoTic;
+    INTCONbits.GIEH = 1;
+    envoyerHistogramme("tic", &h);
+    INTCONbits.GIEH = 0;
+    h = histoCommande;
+    INTCONbits.GIEH = 1;
+    envoyerHistogramme("commande", &h);
+    surveillance_defaut(&d);
+    uart_puts("defaut;");
+    uart_putu(d.cause);
+    uart_putc(';');
+    uart_putu(d.valeur);
+    uart_puts("\r\n");
+}
@@ -0,0 +1,95 @@
+#ifndef SURVEILLANCE_H
+#define SURVEILLANCE_H
+
+#include "iut_temps.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Surveillance des échéances de la commande et chien de garde
+//
+// Chaque tic de commande est daté (surveillance_tic, au début du tic) et
+// la fin de la commande aussi (surveillance_commande). Deux histogrammes
+// en RAM comptent l'écart entre deux tics et la durée tic -> fin de la
+// commande. Les classes ont une largeur en puissance de 2 : un décalage
+// suffit, pas de division sous interruption.
+//
+// Défauts détectés :
+//   - commande terminée plus de SURV_ECHEANCE après le tic
+//   - écart entre deux tics supérieur à SURV_PERIODE + SURV_RETARD
+//   - tic sans commande (scan ADC pas terminé au tic suivant)
+// Au premier défaut, les moteurs sont arrêtés tout de suite et la cause
+// est mémorisée. Le chien de garde n'est alors plus servi, jusqu'au reset.
+//
+// Le chien de garde (WDTPS = 128, environ 0,5 s, iut_init.c) est
+// activé par logiciel après l'initialisation. surveillance_servir(), dans
+// la boucle principale, ne le remet à zéro que si au moins une commande a
+// tenu son échéance depuis le dernier service et qu'aucun défaut n'a été
+// signalé depuis le démarrage. Une boucle principale bloquée (LCD
+// débranché qui ne rend jamais busy), une commande arrêtée ou un défaut
+// provoquent donc un reset. La cause est conservée dans une variable
+// persistent, non effacée par le reset, et relue au démarrage : elle
+// reste affichée et les moteurs arrêtés, mais le chien de garde est de
+// nouveau servi, sans reset en boucle, jusqu'au départ d'une course
+// (surveillance_effacer) ou une mise hors tension.
+///////////////////////////////////////////////////////////////////////////////
+
+// Période nominale du tic de commande (TIC_PERIODE dans suiveur.c)
+#define SURV_PERIODE        TEMPS_PAR_MS
+// Durée maximale entre le tic et la fin de la commande (500 us)
+#define SURV_ECHEANCE       (TEMPS_PAR_MS / 2)
+// Retard maximal d'un tic sur la période nominale (250 us)
+#define SURV_RETARD         (TEMPS_PAR_MS / 4)
+
+// Histogrammes : SURV_NB_CLASSES classes de 2^decalage pas de 0,667 us,
+// la dernière compte aussi tout ce qui dépasse
+#define SURV_NB_CLASSES     8
+#define SURV_DECALAGE_TIC   5   // 32 pas = 21 us, centrées sur la période
+#define SURV_DECALAGE_CMD   6   // 64 pas = 43 us, à partir de 0
+
+// Causes de défaut
+#define SURV_AUCUN      0
+#define SURV_ECHEANCE_DEPASSEE  1
+#define SURV_TIC_EN_RETARD      2
+#define SURV_COMMANDE_MANQUEE   3
+#define SURV_CHIEN_DE_GARDE     4   // reset sans autre cause : boucle bloquée
+
+struct histogramme {
+    unsigned int classe[SURV_NB_CLASSES];   // saturées à 65535
+    unsigned int max;                       // en pas de la base de temps
+};
+
+struct defaut {
+    unsigned char cause;
+    unsigned int valeur;    // durée mesurée en pas de la base de temps
+};
+
+// Relit la cause du dernier reset (temps_init doit avoir été appelé)
+void surveillance_init(void);
+
+// Active le chien de garde, à la fin de l'initialisation
+void surveillance_demarrer(void);
+
+// Au début du tic de commande, priorité haute
+void surveillance_tic(void);
+
+// A la fin de la commande, priorité haute
+void surveillance_commande(void);
+
+// Dans la boucle principale : remet à zéro le chien de garde si tout va bien
+void surveillance_servir(void);
+
+// 1 si un défaut est mémorisé : les moteurs doivent rester arrêtés
+char surveillance_arret(void);
+
+// Copie du défaut mémorisé, renvoie sa cause
+unsigned char surveillance_defaut(struct defaut *d);
+
+// Efface histogrammes et défaut, au départ d'une course
+void surveillance_effacer(void);
+
+// Envoie les histogrammes et le défaut sur la liaison série
+//   tic;c0;...;c7;max
+//   commande;c0;...;c7;max
+//   defaut;cause;valeur
+void surveillance_envoyer(void);
+
+#endif
@@ -0,0 +1,141 @@
+#include <xc.h>
+#include "iut_it.h"
+#include "iut_uart.h"
+#include "iut_usb_cdc.h"
+#include "telemetrie.h"
+
+#ifdef TELEMETRIE
+
+#define TELEM_SYNCHRO   0xA5
+#define TELEM_CHAMPS    6       // champs codés en varint
+#define TELEM_TRAME_MAX (3 + 3 * TELEM_CHAMPS + 1 + 1)
+
+#ifndef USB_CDC
+static unsigned char tampon[TELEM_TAMPON];
+static volatile unsigned char tete = 0;     // écrit par la commande
+static volatile unsigned char queue = 0;    // écrit par l'émission
+#endif
+
+static unsigned char numero;
+static unsigned char avantCle;      // trames avant la prochaine clé
+static int precedents[TELEM_CHAMPS];
+static unsigned int nbTrames, nbPertes;
+
+void telem_init(void) {
+#ifndef USB_CDC
+    it_enregistrer(IT_TX, IT_BASSE, telem_tx_it);
+#endif
+}
+
+void telem_depart(void) {
+    numero = 0;
+    avantCle = 0;
+    nbTrames = 0;
+    nbPertes = 0;
+}
+
+// Ecart zigzag en varint, renvoie le nombre d'octets écrits (3 au plus)
+static unsigned char varint(unsigned char *o, int ecart) {
+    unsigned int z = ((unsigned int) ecart << 1) ^ (unsigned int) (ecart >> 15);
+    unsigned char n = 0;
+
+    while (z >= 0x80) {
+        o[n++] = (unsigned char) z | 0x80;
+        z >>= 7;
+    }
+    o[n++] = (unsigned char) z;
+    return n;
+}
+
+#ifdef USB_CDC
+// Trame rangée d'un bloc dans le tampon d'émission USB
+static char publier(const unsigned char *trame, unsigned char n) {
+    return usb_cdc_ecrire(trame, n);
+}
+#else
+// Trame rangée d'un bloc dans le tampon, émission relancée
+static char publier(const unsigned char *trame, unsigned char n) {
+    unsigned char i, t;
+
+    // place libre : une case reste vide pour distinguer plein et vide
+    t = tete;
+    if (((queue - t - 1) & (TELEM_TAMPON - 1)) < n) return 0;
+    for (i = 0; i < n; i++) {
+        tampon[t] = trame[i];
+        t = (t + 1) & (TELEM_TAMPON - 1);
+    }
+    tete = t;   // trame publiée d'un coup
+    PIE1bits.TXIE = 1;
+    return 1;
+}
+#endif
+
+void telem_envoyer(const struct telem_mesure *m) {
+    unsigned char trame[TELEM_TRAME_MAX];
+    int valeurs[TELEM_CHAMPS];
+    unsigned char c, n, i, somme;
+    char cle = (avantCle == 0);
+
+    valeurs[0] = (int) m->tic;
+    valeurs[1] = m->cd;
+    valeurs[2] = m->cg;
+    valeurs[3] = m->position;
+    valeurs[4] = (int) m->rc_droit;
+    valeurs[5] = (int) m->rc_gauche;
+
+    n = 3;
+    for (c = 0; c < TELEM_CHAMPS; c++) {
+        n += varint(&trame[n], cle ? valeurs[c] : valeurs[c] - precedents[c]);
+    }
+    trame[n++] = m->etat;
+    trame[0] = TELEM_SYNCHRO;
+    trame[1] = numero++;
+    trame[2] = (unsigned char) ((n - 3) | (cle ? 0x80 : 0));
+    somme = 0;
+    for (i = 1; i < n; i++) somme += trame[i];
+    trame[n++] = somme;
+
+    if (!publier(trame, n)) {
+        nbPertes++;
+        avantCle = 0;   // l'hôte a perdu la référence des écarts
+        return;
+    }
+
+    for (c = 0; c < TELEM_CHAMPS; c++) precedents[c] = valeurs[c];
+    avantCle = cle ? TELEM_CLE - 1 : avantCle - 1;
+    nbTrames++;
+}
+
+#ifndef USB_CDC
+// TXIF reste à 1 tant que TXREG est vide : tampon vide, l'interruption
+// est interdite. Une trame publiée entre le test et l'interdiction est
+// vue par le second test.
+void telem_tx_it(void) {
+    unsigned char q = queue;
+
+    if (q == tete) {
+        PIE1bits.TXIE = 0;
+        if (q == tete) return;
+        PIE1bits.TXIE = 1;
+    }
+    TXREG = tampon[q];
+    queue = (q + 1) & (TELEM_TAMPON - 1);
+}
+#endif
+
+// Sur l'USB, la liaison série reste libre pour les rapports
+void telem_attendre(void) {
+#ifndef USB_CDC
+    while (PIE1bits.TXIE);
+#endif
+}
+
+void telem_envoyer_bilan(void) {
+    uart_puts("telemetrie;");
+    uart_putu(nbTrames);
+    uart_putc(';');
+    uart_putu(nbPertes);
+    uart_puts("\r\n");
+}
+
+#endif
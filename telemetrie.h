@@ -0,0 +1,70 @@
+#ifndef TELEMETRIE_H
+#define TELEMETRIE_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Télémétrie binaire pendant la course (compilé avec -DTELEMETRIE)
+//
+// A chaque tic de course, la commande range une trame dans un tampon
+// circulaire ; l'interruption d'émission de l'EUSART (priorité basse) le
+// vide octet par octet. Un seul producteur (routine haute) et un seul
+// consommateur (routine basse), chacun seul à écrire son index de 8 bits :
+// ni verrou ni masquage. La commande n'attend jamais : tampon plein, la
+// trame est perdue et comptée.
+//
+// Trame :
+//   0xA5, numéro (8 bits), entête, données, somme
+//   entête : bit 7 à 1 pour une trame clé, bits 0-6 nombre d'octets de
+//            données
+//   données : tic, CD, CG, position, rc droit, rc gauche, chacun en
+//            varint (7 bits par octet, poids faible en premier, bit 7 à 1
+//            si un octet suit) de l'écart zigzag ((n << 1) ^ (n >> 15))
+//            à la trame précédente, ou à 0 pour une trame clé ; puis un
+//            octet d'état : course (bits 4-7) et suivi (bits 0-3)
+//   somme : somme modulo 256 des octets du numéro à la fin des données
+// Un trou dans les numéros signale des trames perdues ; la trame suivante
+// est alors une trame clé, comme toutes les TELEM_CLE trames, pour que le
+// décodage reparte.
+//
+// Une trame fait 11 à 13 octets en régime établi, 23 au plus : à 1 Mbit/s
+// (100 octets par ms), 1 kHz de trames occupe un peu plus du dixième de la
+// liaison. Les rapports (uart_putc, qui attend) passent après
+// telem_attendre().
+//
+// Avec -DUSB_CDC, les mêmes trames partent sur le port série virtuel USB
+// (iut_usb_cdc.h) au lieu de l'EUSART : 64 octets par ms au moins, la
+// liaison série reste aux rapports. Port fermé côté PC, les trames sont
+// comptées perdues.
+///////////////////////////////////////////////////////////////////////////////
+
+#define TELEM_DEBIT     1000000     // bauds, exact pour Fosc = 48 MHz
+#define TELEM_TAMPON    128         // octets (puissance de 2)
+#define TELEM_CLE       100         // trames entre deux trames clés
+
+struct telem_mesure {
+    unsigned int tic;
+    int cd, cg, position;
+    unsigned int rc_droit, rc_gauche;
+    unsigned char etat;
+};
+
+// Après uart_init : routine d'émission enregistrée en priorité basse
+// (rien avec -DUSB_CDC, usb_cdc_init suffit)
+void telem_init(void);
+
+// Au départ de la course : numéros depuis 0, trame clé, compteurs à zéro
+void telem_depart(void);
+
+// A chaque tic de course, priorité haute
+void telem_envoyer(const struct telem_mesure *m);
+
+// Routine de l'interruption d'émission (IT_TX), priorité basse ; absente
+// avec -DUSB_CDC
+void telem_tx_it(void);
+
+// Attend que le tampon soit vidé, avant d'émettre avec uart_putc
+void telem_attendre(void);
+
+// Envoie les compteurs : telemetrie;trames;pertes
+void telem_envoyer_bilan(void);
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef EEPROM_H
+#define EEPROM_H
+
+///////////////////////////////////////////////////////////////////////////////
+// EEPROM simulée pour les tests sur PC (après <xc.h>, avant le module)
+//
+// Lecture et écriture portent sur le tableau eeprom ; chaque écriture
+// effective est comptée par adresse (usure) et laisse l'EEPROM occupée
+// jusqu'à la prochaine lecture de eeprom_occupee, comme une écriture en
+// cours sur le PIC. Le CRC-8 est celui de iut_eeprom.c.
+///////////////////////////////////////////////////////////////////////////////
+
+#define eeprom_lire     eeprom_lire_pic
+#define eeprom_ecrire   eeprom_ecrire_pic
+#define eeprom_occupee  eeprom_occupee_pic
+#include "iut_eeprom.c"
+#undef eeprom_lire
+#undef eeprom_ecrire
+#undef eeprom_occupee
+
+static unsigned char eeprom[EEPROM_TAILLE];
+static unsigned int eepromEcritures[EEPROM_TAILLE];
+static char eepromEnCours;
+
+// EEPROM effacée, comme un PIC neuf
+static void eeprom_effacer(void) {
+    unsigned int n;
+
+    for (n = 0; n < EEPROM_TAILLE; n++) {
+        eeprom[n] = 0xFF;
+        eepromEcritures[n] = 0;
+    }
+    eepromEnCours = 0;
+}
+
+unsigned char eeprom_lire(unsigned char adresse) {
+    return eeprom[adresse];
+}
+
+void eeprom_ecrire(unsigned char adresse, unsigned char octet) {
+    if (eeprom[adresse] == octet) return;
+    eeprom[adresse] = octet;
+    eepromEcritures[adresse]++;
+    eepromEnCours = 1;
+}
+
+char eeprom_occupee(void) {
+    char occupee = eepromEnCours;
+
+    eepromEnCours = 0;
+    return occupee;
+}
+
+#endif
@@ -0,0 +1,212 @@
+///////////////////////////////////////////////////////////////////////////////
+// Test sur PC de la boîte noire (boite.c)
+//
+// Des courses synthétiques sont enregistrées comme par la commande, figées,
+// copiées en EEPROM simulée par la tâche de fond puis décodées en CSV par
+// boite_envoyer ; chaque ligne est comparée à l'échantillon enregistré :
+//   - course longue : le tampon circulaire fait plusieurs tours, seuls les
+//     derniers blocs restent, écart de position borné puis rattrapé ;
+//   - recherche de la ligne : bloc interrompu puis reprise ;
+//   - reset pendant la course et pendant la copie ;
+//   - copie en cours et EEPROM corrompue.
+//
+// Depuis la racine du dépôt :
+//   gcc -std=gnu99 -Wall -Itest -I. -Ibibliotheque_C_XC8.zip
+//       test/test_boite.c -o /tmp/test_boite
+//   /tmp/test_boite
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <xc.h>
+#include "eeprom.h"
+
+// Liaison série : le texte envoyé est gardé pour le décodage
+static char texte[8192];
+static int nbTexte;
+
+void uart_puts(const char *s) {
+    while (*s) texte[nbTexte++] = *s++;
+}
+
+void uart_putc(unsigned char c) {
+    texte[nbTexte++] = c;
+}
+
+void uart_putu(unsigned long nombre) {
+    nbTexte += sprintf(texte + nbTexte, "%lu", nombre);
+}
+
+#include "boite.c"
+
+#define MAX_ECHANTILLONS    200
+
+struct echantillon {
+    unsigned int tic;
+    int position;
+    unsigned char suivi;
+    char fond;
+    int differentiel;
+};
+
+static struct echantillon enregistres[MAX_ECHANTILLONS];
+static int nbEnregistres;
+
+static void enregistrer(unsigned int tic, int position, unsigned char suivi,
+        char fond, int differentiel) {
+    struct echantillon *e = &enregistres[nbEnregistres++];
+
+    e->tic = tic;
+    e->position = position;
+    e->suivi = suivi;
+    e->fond = fond;
+    e->differentiel = differentiel;
+    boite_echantillon(tic, position, suivi, fond, differentiel);
+}
+
+// Tâche de fond jusqu'à la fin de la copie
+static void copier(void) {
+    struct pt pt = {0};
+    int pas = 0;
+
+    while (etat != BOITE_LIBRE) {
+        boite_ecrire(&pt);
+        assert(++pas < 1000);
+    }
+}
+
+static void envoyer(void) {
+    nbTexte = 0;
+    boite_envoyer();
+    texte[nbTexte] = '\0';
+}
+
+// Consigne décodée : à 512 fronts/s près, arrondie vers -infini, bornée
+static int differentielDecode(int d) {
+    int q = (d >= 0) ? d / 512 : -((-d + 511) / 512);
+
+    if (q > 7) q = 7;
+    if (q < -8) q = -8;
+    return q * 512;
+}
+
+// Décode le CSV et le compare aux échantillons premier à premier + nb - 1 ;
+// position de l'échantillon i lue decalage[i] sous la position vraie. Les
+// positions sont comparées sur 16 bits : l'int du PIC, pas celui du PC.
+static void verifier(unsigned char cause, unsigned int ticArret,
+        int premier, int nb, const int *decalage) {
+    const char *l = texte;
+    unsigned int c, t, tic, etatSuivi, fond;
+    int position, differentiel, i, n;
+    const struct echantillon *e;
+
+    assert(sscanf(l, "boite;%u;%u\r\n%n", &c, &t, &n) == 2);
+    assert(c == cause && t == ticArret);
+    l += n;
+    for (i = premier; i < premier + nb; i++) {
+        e = &enregistres[i];
+        assert(sscanf(l, "%u;%d;%u;%u;%d\r\n%n", &tic, &position,
+                &etatSuivi, &fond, &differentiel, &n) == 5);
+        assert(tic == e->tic);
+        assert((short) position
+                == e->position - (decalage ? decalage[i] : 0));
+        assert(etatSuivi == e->suivi && fond == (unsigned int) (e->fond != 0));
+        assert(differentiel == differentielDecode(e->differentiel));
+        l += n;
+    }
+    assert(*l == '\0');
+}
+
+// 100 échantillons : les 6 derniers blocs restent, soit 5 blocs pleins et
+// les 4 échantillons du bloc en cours ; un saut de 300 au rang 2 d'un
+// bloc est rattrapé en 3 échantillons, par écarts de 127 au plus
+static void courseLongue(void) {
+    static int decalage[MAX_ECHANTILLONS];
+    int i, position = 0;
+
+    boite_depart();
+    nbEnregistres = 0;
+    for (i = 0; i < 100; i++) {
+        position += (i == 74) ? 300 : (i * 37) % 201 - 100;
+        enregistrer(i * BOITE_PAS, position, i % 7, i % 5 == 0,
+                (i * 997) % 9000 - 4500);
+    }
+    decalage[74] = 173;     // 176 lu 3
+    decalage[75] = 108;     // 238 lu 3 + 127
+    decalage[76] = 80;      // 337 lu 3 + 2 x 127
+    boite_figer(BOITE_JCK, 400);
+
+    envoyer();
+    assert(!strcmp(texte, "boite;copie en cours\r\n"));
+    copier();
+    envoyer();
+    verifier(BOITE_JCK, 400, 100 - 44, 44, decalage);
+}
+
+// Recherche de la ligne : bloc interrompu au rang 4, puis à la limite
+// d'un bloc (sans effet), reprise avec de nouveaux tics ; arrêt sur un bloc
+// vide après 6 blocs écrits : aucun échantillon n'est perdu
+static void recherche(void) {
+    int i;
+
+    boite_depart();
+    nbEnregistres = 0;
+    for (i = 0; i < 20; i++) enregistrer(i * BOITE_PAS, i, 1, 0, 0);
+    boite_interrompre();
+    boite_interrompre();
+    for (i = 40; i < 52; i++) enregistrer(i * BOITE_PAS, -i, 2, 1, 512);
+    boite_interrompre();
+    for (i = 80; i < 83; i++) enregistrer(i * BOITE_PAS, i, 3, 0, -512);
+    boite_interrompre();
+    boite_figer(BOITE_PERDUE, 90 * BOITE_PAS);
+    copier();
+    envoyer();
+    verifier(BOITE_PERDUE, 90 * BOITE_PAS, 0, nbEnregistres, 0);
+}
+
+// Reset du chien de garde pendant la course, puis pendant la copie : le
+// tampon persistent est figé au redémarrage, la copie reprend
+static void resets(void) {
+    struct pt pt = {0};
+    int i;
+
+    RCONbits.nPOR = 1;
+    boite_depart();
+    nbEnregistres = 0;
+    for (i = 0; i < 10; i++) enregistrer(i * BOITE_PAS, 10 * i, 4, 0, 0);
+    boite_init();
+    assert(etat == BOITE_FIGEE);
+    for (i = 0; i < 5; i++) boite_ecrire(&pt);
+    assert(etat == BOITE_FIGEE && pt.ligne != 0);   // copie entamée
+    boite_init();
+    assert(etat == BOITE_FIGEE);
+    copier();
+    envoyer();
+    verifier(BOITE_RESET, 9 * BOITE_PAS, 0, 10, 0);
+
+    // mise sous tension : rien à reprendre
+    RCONbits.nPOR = 0;
+    boite_init();
+    assert(etat == BOITE_LIBRE);
+}
+
+int main(void) {
+    eeprom_effacer();
+    RCONbits.nPOR = 0;
+    boite_init();
+    envoyer();
+    assert(!strcmp(texte, "boite;vide\r\n"));
+
+    courseLongue();
+    recherche();
+    resets();
+
+    // un octet des blocs modifié : CRC faux
+    eeprom[BOITE_ADRESSE + BOITE_ENTETE + 5] ^= 1;
+    envoyer();
+    assert(!strcmp(texte, "boite;vide\r\n"));
+
+    puts("boite : ok");
+    return 0;
+}
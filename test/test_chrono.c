@@ -0,0 +1,169 @@
+///////////////////////////////////////////////////////////////////////////////
+// Test sur PC du chronométrage et du record en EEPROM (chrono.c)
+//
+// Des courses synthétiques (dates des marques dans la base de temps) sont
+// chronométrées et leurs tours ajoutés au record, en EEPROM simulée :
+//   - tours entre deux marques, course entière sur une piste sans repère,
+//     courses abandonnées ou arrêtées avant la première marque ;
+//   - écritures réparties sur les CHRONO_PLACES emplacements, numéros qui
+//     rebouclent après 255 ;
+//   - emplacement le plus récent corrompu : le précédent est relu ;
+//     aucun emplacement valable : record à zéro.
+//
+// Depuis la racine du dépôt :
+//   gcc -std=gnu99 -Wall -Itest -I. -Ibibliotheque_C_XC8.zip
+//       test/test_chrono.c -o /tmp/test_chrono
+//   /tmp/test_chrono
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <xc.h>
+#include "eeprom.h"
+
+void uart_puts(const char *s) {
+    (void) s;
+}
+
+void uart_putc(unsigned char c) {
+    (void) c;
+}
+
+void uart_putu(unsigned long nombre) {
+    (void) nombre;
+}
+
+#include "chrono.c"
+
+// 1 s en pas de la base de temps (2/3 us)
+#define SECONDE     1500000UL
+
+static void repere(unsigned char type, unsigned long date) {
+    struct repere r;
+
+    r.type = type;
+    r.date = date;
+    r.distance = 0;
+    r.longueur = 0;
+    chrono_repere(&r);
+}
+
+static void recordEgal(const struct chrono_record *a) {
+    assert(chronoRecord.meilleur == a->meilleur);
+    assert(chronoRecord.dernier == a->dernier);
+    assert(chronoRecord.nombre == a->nombre);
+    assert(chronoRecord.somme == a->somme);
+}
+
+// Départ, ligne à 1 s puis tours de 10 s + k ms, temps intermédiaire à
+// 4 s, arrêt par JCK 2 s après la dernière ligne
+static void courseMarquee(unsigned char nb, unsigned int k) {
+    unsigned long date = SECONDE;
+    unsigned char t;
+
+    chrono_depart(0);
+    repere(CHRONO_LIGNE, date);
+    for (t = 0; t < nb; t++) {
+        repere(REPERE_CROISEMENT, date + 4 * SECONDE);
+        date += 10 * SECONDE + k * (SECONDE / 1000);
+        repere(CHRONO_LIGNE, date);
+    }
+    chrono_fin(date + 2 * SECONDE, 1);
+}
+
+static void chronometrage(void) {
+    chrono_charger();
+    assert(chronoRecord.nombre == 0 && chronoRecord.meilleur == 0);
+
+    // 3 tours de 10,005 s : temps intermédiaire à 4 s
+    courseMarquee(3, 5);
+    assert(chrono_nombre() == 3);
+    assert(tours[0].duree == 10005000UL && tours[0].inter[0] == 4000000UL);
+    assert(chronoRecord.nombre == 3 && chronoRecord.meilleur == 10005000UL);
+    assert(chronoRecord.somme == 3 * 10005UL && chrono_moyenne() == 10005);
+
+    // course abandonnée avant la première marque : rien
+    chrono_depart(0);
+    chrono_fin(SECONDE / 2, 0);
+    assert(chrono_nombre() == 0 && chronoRecord.nombre == 3);
+
+    // piste sans repère (trous exceptés) : la course entière, si l'arrêt
+    // est normal
+    chrono_depart(0);
+    repere(REPERE_TROU, SECONDE);
+    chrono_fin(9 * SECONDE, 1);
+    assert(chrono_nombre() == 1 && chronoRecord.meilleur == 9000000UL);
+    chrono_depart(0);
+    chrono_fin(8 * SECONDE, 0);
+    assert(chrono_nombre() == 0 && chronoRecord.nombre == 4);
+
+    // piste marquée arrêtée avant la ligne : pas de tour
+    chrono_depart(0);
+    repere(REPERE_CROISEMENT, SECONDE);
+    chrono_fin(3 * SECONDE, 1);
+    assert(chrono_nombre() == 0 && chronoRecord.nombre == 4);
+    assert(chronoRecord.dernier == 9000000UL);
+}
+
+// Emplacement du record le plus récent
+static unsigned char adresseRecente(void) {
+    return CHRONO_ADRESSE + place * CHRONO_TAILLE;
+}
+
+static void usure(void) {
+    unsigned int s, p, max = 0, min = 0xFFFF;
+    struct chrono_record avant;
+
+    eeprom_effacer();
+    chrono_charger();
+    // 300 courses d'un tour : les numéros rebouclent
+    for (s = 0; s < 300; s++) {
+        courseMarquee(1, s % 50);
+        assert(adresseRecente() == CHRONO_ADRESSE
+                + (s % CHRONO_PLACES) * CHRONO_TAILLE);
+    }
+    assert(chronoRecord.nombre == 300);
+    assert(chronoRecord.meilleur == 10000000UL);
+    assert(chronoRecord.dernier == 10000000UL + 299 % 50 * 1000UL);
+
+    // écritures du numéro également réparties
+    for (p = 0; p < CHRONO_PLACES; p++) {
+        s = eepromEcritures[CHRONO_ADRESSE + p * CHRONO_TAILLE];
+        if (s > max) max = s;
+        if (s < min) min = s;
+    }
+    assert(max == 300 / CHRONO_PLACES && min == max);
+
+    // relecture après un redémarrage
+    avant = chronoRecord;
+    memset(&chronoRecord, 0, sizeof(chronoRecord));
+    chrono_charger();
+    recordEgal(&avant);
+    courseMarquee(1, 0);
+    assert(adresseRecente() == CHRONO_ADRESSE);     // suite de la rotation
+
+    // emplacement le plus récent corrompu (coupure pendant l'écriture) :
+    // le record d'avant la dernière course est relu
+    eeprom[adresseRecente() + 3] ^= 0x40;
+    chrono_charger();
+    recordEgal(&avant);
+    assert(adresseRecente() == CHRONO_ADRESSE + 3 * CHRONO_TAILLE);
+
+    // plus aucun emplacement valable : record à zéro, écriture en 0
+    for (p = 0; p < CHRONO_PLACES; p++) {
+        eeprom[CHRONO_ADRESSE + p * CHRONO_TAILLE + CHRONO_TAILLE - 1] ^= 1;
+    }
+    chrono_charger();
+    assert(chronoRecord.nombre == 0 && chronoRecord.meilleur == 0);
+    courseMarquee(1, 0);
+    assert(adresseRecente() == CHRONO_ADRESSE && chronoRecord.nombre == 1);
+}
+
+int main(void) {
+    eeprom_effacer();
+    chronometrage();
+    usure();
+    puts("chrono : ok");
+    return 0;
+}
@@ -0,0 +1,160 @@
+///////////////////////////////////////////////////////////////////////////////
+// Test sur PC du classement des repères de la piste (reperes.c)
+//
+// Des traces synthétiques de CG et CD, à 2 fronts de codeur par tic, sont
+// passées à reperes_tic comme par la commande :
+//   - croisement, marque à droite (départ et arrivée, CHRONO_LIGNE),
+//     marque à gauche, trou, chacun daté et mesuré ;
+//   - parasite d'un tic, ligne large, ligne perdue : pas de repère ;
+//   - position à ignorer pendant un croisement ou une marque ;
+//   - file pleine : repères perdus, compteurs justes.
+//
+// Depuis la racine du dépôt :
+//   gcc -std=gnu99 -Wall -Itest -I. -Ibibliotheque_C_XC8.zip
+//       test/test_reperes.c -o /tmp/test_reperes
+//   /tmp/test_reperes
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <assert.h>
+#include <xc.h>
+#include "iut_codeurs.h"
+#include "parametres.h"
+#include "chrono.h"
+
+#define PLEIN   850
+#define FOND    200
+#define LIGNE   500     // capteur sur le bord de la ligne
+#define BLANC   900
+#define NOIR    100
+
+int param[PARAM_NB];
+
+static unsigned long fronts;    // distance parcourue, les deux roues
+static unsigned long date;      // tics
+
+unsigned long codeurs_nombre(unsigned char codeur) {
+    (void) codeur;
+    return fronts;
+}
+
+void uart_puts(const char *s) {
+    (void) s;
+}
+
+void uart_putc(unsigned char c) {
+    (void) c;
+}
+
+void uart_putu(unsigned long nombre) {
+    (void) nombre;
+}
+
+#include "reperes.c"
+
+// nb tics de mesures cg, cd ; renvoie le nombre de tics où la position
+// est à ignorer
+static int passer(int cg, int cd, int nb) {
+    int ignores = 0;
+
+    while (nb--) {
+        fronts += 2;
+        ignores += reperes_tic(++date, cg, cd);
+    }
+    return ignores;
+}
+
+// Motif de nb tics encadré de ligne, puis repère attendu (ou aucun)
+static void motifSeul(int cg, int cd, int nb, char attendu,
+        unsigned char type) {
+    struct repere r;
+    unsigned long debut, distanceDebut;
+
+    passer(LIGNE, LIGNE, 5);
+    debut = date + REPERES_CONFIRMATION;    // daté à la confirmation
+    distanceDebut = fronts + 2 * REPERES_CONFIRMATION - origine;
+    passer(cg, cd, nb);
+    passer(LIGNE, LIGNE, 5);
+    if (!attendu) {
+        assert(!reperes_lire(&r));
+        return;
+    }
+    assert(reperes_lire(&r));
+    assert(r.type == type && r.date == debut);
+    assert(r.distance == distanceDebut);
+    assert(r.longueur == 2 * nb);
+    assert(!reperes_lire(&r));
+}
+
+static void classement(void) {
+    fronts = 1000;
+    param[PARAM_PLEIN] = PLEIN;
+    param[PARAM_FOND] = FOND;
+    reperes_depart();
+
+    motifSeul(BLANC, BLANC, 10, 1, REPERE_CROISEMENT);
+    motifSeul(LIGNE, BLANC, 8, 1, REPERE_MARQUE_D);
+    motifSeul(BLANC, LIGNE, 8, 1, REPERE_MARQUE_G);
+    motifSeul(NOIR, NOIR, 40, 1, REPERE_TROU);
+    assert(reperes_nombre(CHRONO_LIGNE) == 1);
+
+    // longueurs limites : compris, puis trop long
+    motifSeul(BLANC, BLANC, REPERES_CROISEMENT_MAX / 2, 1, REPERE_CROISEMENT);
+    motifSeul(BLANC, BLANC, REPERES_CROISEMENT_MAX / 2 + 1, 0, 0);
+    motifSeul(LIGNE, BLANC, REPERES_MARQUE_MAX / 2 + 1, 0, 0);
+    motifSeul(NOIR, NOIR, REPERES_TROU_MAX / 2 + 1, 0, 0);
+
+    // parasite plus court que la confirmation
+    motifSeul(BLANC, BLANC, REPERES_CONFIRMATION - 1, 0, 0);
+    motifSeul(LIGNE, BLANC, REPERES_CONFIRMATION - 1, 0, 0);
+
+    assert(reperes_nombre(REPERE_CROISEMENT) == 2);
+    assert(reperes_nombre(REPERE_MARQUE_D) == 1);
+    assert(reperes_nombre(REPERE_MARQUE_G) == 1);
+    assert(reperes_nombre(REPERE_TROU) == 1);
+}
+
+// Position à ignorer pendant un croisement, puis plus au-delà de la
+// longueur d'un croisement (ligne large) ; jamais pendant un trou
+static void positionIgnoree(void) {
+    struct repere r;
+
+    passer(LIGNE, LIGNE, 5);
+    assert(passer(BLANC, BLANC, 10) == 10);
+    assert(passer(LIGNE, LIGNE, 5) == 0);
+    assert(passer(BLANC, BLANC, 40) == REPERES_CROISEMENT_MAX / 2
+            + REPERES_CONFIRMATION);
+    assert(passer(NOIR, NOIR, 10) == 0);
+    passer(LIGNE, LIGNE, 5);
+    while (reperes_lire(&r));
+}
+
+// File de REPERES_FILE - 1 repères : les suivants sont perdus, comptés
+static void filePleine(void) {
+    struct repere r;
+    int n;
+
+    reperes_depart();
+    for (n = 0; n < REPERES_FILE + 3; n++) {
+        passer(LIGNE, LIGNE, 5);
+        passer(n % 2 ? LIGNE : BLANC, BLANC, 6);
+    }
+    passer(LIGNE, LIGNE, 5);
+    assert(reperes_nombre(REPERE_CROISEMENT)
+            + reperes_nombre(REPERE_MARQUE_D) == REPERES_FILE + 3);
+    for (n = 0; reperes_lire(&r); n++) {
+        assert(r.type == (n % 2 ? REPERE_MARQUE_D : REPERE_CROISEMENT));
+    }
+    assert(n == REPERES_FILE - 1);
+
+    // file vidée : les repères suivants y entrent
+    motifSeul(LIGNE, BLANC, 6, 1, REPERE_MARQUE_D);
+}
+
+int main(void) {
+    classement();
+    positionIgnoree();
+    filePleine();
+    puts("reperes : ok");
+    return 0;
+}
@@ -0,0 +1,173 @@
+///////////////////////////////////////////////////////////////////////////////
+// Test sur PC de la télémétrie binaire (telemetrie.c, liaison EUSART)
+//
+// Une course de TEST_TICS tics est jouée : à chaque tic, la commande
+// envoie une mesure, puis la routine d'émission sort au plus le nombre
+// d'octets que la liaison passe en un tic. Pendant la fenêtre LENT_DEBUT
+// - LENT_FIN la liaison est ralentie et le tampon déborde : des trames
+// sont perdues. Le flot d'octets est ensuite décodé comme le ferait le
+// PC : sommes justes, chaque trame décodée égale à la mesure envoyée,
+// chaque perte vue comme un trou dans les numéros et suivie d'une trame
+// clé, pertes et trames comptées comme par telem_envoyer_bilan.
+//
+// Les écarts entre mesures restent petits : sur le PC l'int a 32 bits,
+// le codage zigzag n'y est celui du PIC que pour des écarts de 16 bits.
+//
+// Depuis la racine du dépôt :
+//   gcc -std=gnu99 -Wall -Itest -I. -Ibibliotheque_C_XC8.zip
+//       test/test_telemetrie.c -o /tmp/test_telemetrie
+//   /tmp/test_telemetrie
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <assert.h>
+
+#define TELEMETRIE
+#include <xc.h>
+#include "iut_it.h"
+#include "iut_uart.h"
+
+void it_enregistrer(unsigned char source, unsigned char priorite,
+        void (*fonction)(void)) {
+    (void) source;
+    (void) priorite;
+    (void) fonction;
+}
+
+void uart_puts(const char *s) {
+    fputs(s, stdout);
+}
+
+void uart_putc(unsigned char c) {
+    putchar(c);
+}
+
+void uart_putu(unsigned long nombre) {
+    printf("%lu", nombre);
+}
+
+#include "telemetrie.c"
+
+#define TEST_TICS       5000
+#define OCTETS_PAR_TIC  14      // un peu plus que la trame moyenne
+#define LENT_DEBUT      2000
+#define LENT_FIN        2100
+#define OCTETS_LENT     2
+
+static struct telem_mesure mesures[TEST_TICS];
+static unsigned char sortie[TEST_TICS * TELEM_TRAME_MAX];
+static long nbSortie;
+
+// Générateur pseudo-aléatoire, le même sur toutes les machines
+static unsigned long graine = 1;
+
+static int aleatoire(int n) {
+    graine = graine * 1103515245UL + 12345UL;
+    return (int) ((graine >> 16) % (unsigned long) n);
+}
+
+// Course : capteurs en marche aléatoire, une trame par tic
+static void produire(void) {
+    int t, b, budget, cd = 500, cg = 480;
+    unsigned char q;
+    struct telem_mesure *m;
+
+    telem_depart();
+    for (t = 0; t < TEST_TICS; t++) {
+        cd += aleatoire(21) - 10;
+        cg += aleatoire(21) - 10;
+        m = &mesures[t];
+        m->tic = t;
+        m->cd = cd;
+        m->cg = cg;
+        m->position = cd - cg;
+        m->rc_droit = 300 + t % 50;
+        m->rc_gauche = 280 + aleatoire(40);
+        m->etat = 0x12;
+        telem_envoyer(m);
+
+        budget = (t >= LENT_DEBUT && t < LENT_FIN) ? OCTETS_LENT
+                : OCTETS_PAR_TIC;
+        for (b = 0; b < budget && PIE1bits.TXIE; b++) {
+            q = queue;
+            telem_tx_it();
+            if (queue != q) sortie[nbSortie++] = TXREG;
+        }
+    }
+    // fin de course : le tampon se vide
+    while (PIE1bits.TXIE) {
+        q = queue;
+        telem_tx_it();
+        if (queue != q) sortie[nbSortie++] = TXREG;
+    }
+}
+
+// Varint zigzag, ramené à 16 bits comme sur le PIC
+static int lireVarint(long *p) {
+    unsigned int z = 0, decalage = 0;
+
+    while (sortie[*p] & 0x80) {
+        z |= (unsigned int) (sortie[(*p)++] & 0x7F) << decalage;
+        decalage += 7;
+    }
+    z |= (unsigned int) sortie[(*p)++] << decalage;
+    return (short) ((z >> 1) ^ -(z & 1));
+}
+
+int main(void) {
+    long p = 0, d;
+    int c, v[TELEM_CHAMPS], precedent[TELEM_CHAMPS] = {0};
+    unsigned char numero, entete, somme, attendu = 0;
+    unsigned int trames = 0, pertes = 0, trous = 0;
+    char premier = 1;
+    const struct telem_mesure *m;
+
+    produire();
+
+    while (p < nbSortie) {
+        assert(sortie[p] == TELEM_SYNCHRO);
+        numero = sortie[p + 1];
+        entete = sortie[p + 2];
+        somme = 0;
+        for (d = p + 1; d < p + 3 + (entete & 0x7F); d++) somme += sortie[d];
+        assert(somme == sortie[p + 3 + (entete & 0x7F)]);
+
+        // trou dans les numéros : trames perdues, la suivante est une clé
+        if (premier || numero != attendu) {
+            if (!premier) {
+                pertes += (unsigned char) (numero - attendu);
+                trous++;
+            }
+            assert(entete & 0x80);
+        }
+        premier = 0;
+        attendu = numero + 1;
+
+        d = p + 3;
+        for (c = 0; c < TELEM_CHAMPS; c++) {
+            v[c] = lireVarint(&d);
+            if (!(entete & 0x80)) v[c] = (short) (precedent[c] + v[c]);
+            precedent[c] = v[c];
+        }
+        assert(d == p + 3 + (entete & 0x7F) - 1);
+
+        m = &mesures[v[0]];
+        assert((unsigned char) v[0] == numero);
+        assert(v[1] == m->cd && v[2] == m->cg && v[3] == m->position);
+        assert(v[4] == (int) m->rc_droit && v[5] == (int) m->rc_gauche);
+        assert(sortie[d] == m->etat);
+        trames++;
+        p = d + 2;
+    }
+    assert(p == nbSortie);
+
+    // toutes les trames partent, sauf les pertes de la liaison lente
+    assert(trames == nbTrames && pertes == nbPertes);
+    assert(trames + pertes == TEST_TICS && pertes > 0);
+
+    printf("%u trames, %u perdues en %u trous, %ld octets\n",
+            trames, pertes, trous, nbSortie);
+    telem_envoyer_bilan();
+    puts("telemetrie : ok");
+    return 0;
+}
@@ -0,0 +1,289 @@
+///////////////////////////////////////////////////////////////////////////////
+// Test sur PC du port série virtuel USB (iut_usb_cdc.c)
+//
+// Le test joue le PC et le module USB : il remplit la table des
+// descripteurs comme le ferait le module, lève les drapeaux de UIR et
+// appelle la routine d'interruption. Enumération, requêtes CDC, émission
+// et réception en boucle sont vérifiées ; le premier écart arrête le test.
+//
+// Depuis la racine du dépôt (adresses de 16 bits sur le PIC : la
+// conversion des pointeurs tronque, sans effet sur le test) :
+//   gcc -std=gnu99 -Wall -Wno-pointer-to-int-cast -Itest
+//       -Ibibliotheque_C_XC8.zip test/test_usb_cdc.c -o /tmp/test_usb_cdc
+//   /tmp/test_usb_cdc
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <xc.h>
+#include "iut_it.h"
+
+// Routine enregistrée par usb_cdc_init
+static void (*routine)(void);
+
+void it_enregistrer(unsigned char source, unsigned char priorite,
+        void (*fonction)(void)) {
+    (void) source;
+    (void) priorite;
+    routine = fonction;
+}
+
+#include "iut_usb_cdc.c"
+
+#define PID_OUT 0x01
+#define PID_IN  0x09
+
+// Fin de transaction sur le descripteur bd : le module rend le descripteur
+// (avec le PID en sortie) et signale TRNIF
+static void transaction(int bd, unsigned char pid) {
+    if (!(bd & 1)) {
+        usb_bdt[bd].stat = pid << 2;
+    } else {
+        usb_bdt[bd].stat &= ~BD_UOWN;
+    }
+    USTAT = bd << 2;
+    UIRbits.TRNIF = 1;
+    routine();
+}
+
+static void trame(void) {
+    UIRbits.SOFIF = 1;
+    routine();
+}
+
+static void setup(unsigned char type, unsigned char requete,
+        unsigned int valeur, unsigned int index, unsigned int longueur) {
+    unsigned char p[8];
+
+    p[0] = type;
+    p[1] = requete;
+    p[2] = valeur;
+    p[3] = valeur >> 8;
+    p[4] = index;
+    p[5] = index >> 8;
+    p[6] = longueur;
+    p[7] = longueur >> 8;
+    assert(usb_bdt[BD_EP0_OUT].stat & BD_UOWN);
+    memcpy((void *) usb_ep0_out, p, 8);
+    usb_bdt[BD_EP0_OUT].cnt = 8;
+    transaction(BD_EP0_OUT, PID_SETUP);
+    assert(usb_bdt[BD_EP0_OUT].stat & BD_UOWN);
+}
+
+// Etape de données IN jusqu'au paquet court ou à max octets ; renvoie
+// le nombre d'octets, paquets reçoit le nombre de paquets
+static int lireIn(unsigned char *o, int max, int *paquets) {
+    int n = 0;
+    unsigned char dts = BD_DTS;
+    unsigned char s, c;
+
+    *paquets = 0;
+    for (;;) {
+        s = usb_bdt[BD_EP0_IN].stat;
+        c = usb_bdt[BD_EP0_IN].cnt;
+        assert(s & BD_UOWN);
+        assert(!(s & BD_BSTALL));
+        assert((s & BD_DTS) == dts);    // DATA1, DATA0, ...
+        dts ^= BD_DTS;
+        memcpy(o + n, (void *) usb_ep0_in, c);
+        n += c;
+        (*paquets)++;
+        transaction(BD_EP0_IN, PID_IN);
+        if (c < EP0_TAILLE || n >= max) break;
+    }
+    assert(!(usb_bdt[BD_EP0_IN].stat & BD_UOWN));
+    return n;
+}
+
+// Etape d'état après une lecture : paquet OUT vide
+static void etatOut(void) {
+    usb_bdt[BD_EP0_OUT].cnt = 0;
+    transaction(BD_EP0_OUT, PID_OUT);
+}
+
+// Etape d'état après une écriture : paquet IN vide en DATA1
+static void etatIn(void) {
+    assert(usb_bdt[BD_EP0_IN].stat & BD_UOWN);
+    assert(usb_bdt[BD_EP0_IN].cnt == 0);
+    assert(usb_bdt[BD_EP0_IN].stat & BD_DTS);
+    transaction(BD_EP0_IN, PID_IN);
+}
+
+static void enumeration(void) {
+    unsigned char b[256];
+    int n, p;
+
+    // reset du bus
+    UIRbits.URSTIF = 1;
+    routine();
+    assert(UEP0 == UEP_CONTROLE);
+
+    // GET_DESCRIPTOR appareil, SET_ADDRESS pris après l'état
+    setup(0x80, 6, 0x0100, 0, 64);
+    n = lireIn(b, 64, &p);
+    etatOut();
+    assert(n == 18 && p == 3 && !memcmp(b, usb_appareil, 18));
+    setup(0x00, 5, 7, 0, 0);
+    assert(UADDR == 0);
+    etatIn();
+    assert(UADDR == 7);
+
+    // configuration : entête seule, entière, tronquée à la demande
+    setup(0x80, 6, 0x0200, 0, 9);
+    n = lireIn(b, 9, &p);
+    etatOut();
+    assert(n == 9 && b[2] == sizeof(usb_configuration_desc));
+    setup(0x80, 6, 0x0200, 0, 255);
+    n = lireIn(b, 255, &p);
+    etatOut();
+    assert(n == 67 && p == 9 && !memcmp(b, usb_configuration_desc, 67));
+    setup(0x80, 6, 0x0200, 0, 64);
+    n = lireIn(b, 64, &p);
+    etatOut();
+    assert(n == 64 && p == 8);  // longueur atteinte : pas de paquet vide
+
+    // chaîne du produit ; réponse multiple de 8 plus courte que la
+    // demande : paquet vide final
+    setup(0x80, 6, 0x0302, 0x0409, 255);
+    n = lireIn(b, 255, &p);
+    etatOut();
+    assert(n == 34 && p == 5 && b[2] == 'S');
+    usb_ep0_repondre(usb_configuration_desc, 16, 255);
+    n = lireIn(b, 255, &p);
+    assert(n == 16 && p == 3);
+
+    // chaîne absente, requête inconnue : STALL
+    setup(0x80, 6, 0x0305, 0, 255);
+    assert(usb_bdt[BD_EP0_IN].stat & BD_BSTALL);
+    setup(0x80, 0x33, 0, 0, 0);
+    assert(usb_bdt[BD_EP0_IN].stat & BD_BSTALL);
+
+    setup(0x00, 9, 1, 0, 0);
+    etatIn();
+    assert(UEP2 == UEP_IN_OUT && usb_configuration == 1);
+}
+
+static void requetesCdc(void) {
+    static const unsigned char codage[7] = {0x40, 0x42, 0x0F, 0, 0, 0, 8};
+    unsigned char b[8];
+    int n, p;
+
+    // SET_LINE_CODING puis GET_LINE_CODING
+    setup(0x21, 0x20, 0, 0, 7);
+    memcpy((void *) usb_ep0_out, codage, 7);
+    usb_bdt[BD_EP0_OUT].cnt = 7;
+    transaction(BD_EP0_OUT, PID_OUT);
+    etatIn();
+    setup(0xA1, 0x21, 0, 0, 7);
+    n = lireIn(b, 7, &p);
+    etatOut();
+    assert(n == 7 && !memcmp(b, codage, 7));
+
+    // rien n'est émis avant DTR
+    assert(!usb_cdc_pret());
+    assert(!usb_cdc_ecrire(b, 1));
+    setup(0x21, 0x22, 3, 0, 0);
+    etatIn();
+    assert(usb_cdc_pret());
+}
+
+// 300 octets par blocs de 13 : paquets de 64 dans l'ordre, DATA0/DATA1
+// alternés, paquet court final
+static void emission(void) {
+    unsigned char b[USB_CDC_EMISSION], recu[400];
+    int envoyes = 0, nbRecus = 0, pleins = 0, i, c;
+    unsigned char dts = 0;
+
+    while (envoyes < 300 || usb_emission_tete != usb_emission_queue
+            || (usb_bdt[BD_EP2_IN].stat & BD_UOWN)) {
+        c = (300 - envoyes < 13) ? 300 - envoyes : 13;
+        for (i = 0; i < c; i++) b[i] = envoyes + i;
+        if (c && usb_cdc_ecrire(b, c)) {
+            envoyes += c;
+        } else {
+            trame();
+        }
+        if (usb_bdt[BD_EP2_IN].stat & BD_UOWN) {
+            c = usb_bdt[BD_EP2_IN].cnt;
+            assert((usb_bdt[BD_EP2_IN].stat & BD_DTS) == dts);
+            dts ^= BD_DTS;
+            memcpy(recu + nbRecus, (void *) usb_ep2_in, c);
+            nbRecus += c;
+            if (c == EP2_TAILLE) pleins++;
+            transaction(BD_EP2_IN, PID_IN);
+        }
+    }
+    assert(nbRecus == 300 && pleins >= 1);
+    for (i = 0; i < nbRecus; i++) assert(recu[i] == (unsigned char) i);
+    assert(usb_cdc_place() == USB_CDC_EMISSION);
+
+    // tampon plein : le bloc entier ou rien ; 128 octets partent en deux
+    // paquets pleins suivis d'un paquet vide
+    memset(b, 0, sizeof(b));
+    assert(usb_cdc_ecrire(b, USB_CDC_EMISSION));
+    assert(!usb_cdc_ecrire(b, 1));
+    assert(usb_cdc_place() == 0);
+    {
+        int tailles[4], k = 0;
+
+        while (k < 4) {
+            if (usb_bdt[BD_EP2_IN].stat & BD_UOWN) {
+                tailles[k++] = usb_bdt[BD_EP2_IN].cnt;
+                transaction(BD_EP2_IN, PID_IN);
+            } else {
+                trame();
+                if (!(usb_bdt[BD_EP2_IN].stat & BD_UOWN)) break;
+            }
+        }
+        assert(k == 3 && tailles[0] == 64 && tailles[1] == 64
+                && tailles[2] == 0);
+    }
+}
+
+// Deux paquets de 64 : le second attend la place, le PC reçoit NAK
+static void reception(void) {
+    unsigned char o[EP2_TAILLE];
+    int i, n;
+
+    for (i = 0; i < EP2_TAILLE; i++) usb_ep2_out[i] = i;
+    assert((usb_bdt[BD_EP2_OUT].stat & (BD_UOWN | BD_DTS)) == BD_UOWN);
+    usb_bdt[BD_EP2_OUT].cnt = EP2_TAILLE;
+    transaction(BD_EP2_OUT, PID_OUT);
+    assert((usb_bdt[BD_EP2_OUT].stat & (BD_UOWN | BD_DTS))
+            == (BD_UOWN | BD_DTS));
+    for (i = 0; i < EP2_TAILLE; i++) usb_ep2_out[i] = EP2_TAILLE + i;
+    usb_bdt[BD_EP2_OUT].cnt = EP2_TAILLE;
+    transaction(BD_EP2_OUT, PID_OUT);
+    assert(!(usb_bdt[BD_EP2_OUT].stat & BD_UOWN));
+
+    n = usb_cdc_lire(o, 10);
+    assert(n == 10 && o[9] == 9);
+    trame();
+    assert(!(usb_bdt[BD_EP2_OUT].stat & BD_UOWN));  // 54 octets libres
+    n = usb_cdc_lire(o, EP2_TAILLE);
+    assert(n == 54 && o[53] == 63);
+    trame();
+    assert(usb_bdt[BD_EP2_OUT].stat & BD_UOWN);
+    n = usb_cdc_lire(o, EP2_TAILLE);
+    assert(n == 64 && o[0] == 64 && o[63] == 127);
+    assert(usb_cdc_lire(o, EP2_TAILLE) == 0);
+}
+
+int main(void) {
+    usb_cdc_init();
+    assert(routine && UCONbits.USBEN && UCFG == 0x14);
+
+    enumeration();
+    requetesCdc();
+    emission();
+    reception();
+
+    // reset du bus : déconfiguré, port fermé
+    UIRbits.URSTIF = 1;
+    routine();
+    assert(!usb_cdc_pret() && UADDR == 0 && UEP2 == 0);
+
+    puts("usb_cdc : ok");
+    return 0;
+}
@@ -0,0 +1,57 @@
+#ifndef XC_H
+#define XC_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Remplace <xc.h> pour compiler un test sur le PC (gcc -Itest)
+//
+// Les mots clés de xc8 disparaissent ; les registres utilisés par les
+// modules testés sont des variables ordinaires, l'octet et les bits
+// séparés (ils ne se recouvrent pas comme sur le PIC). Un test est un
+// seul fichier source qui inclut le .c testé : les registres sont définis
+// ici, une fois.
+///////////////////////////////////////////////////////////////////////////////
+
+#define interrupt
+#define persistent
+#define high_priority
+#define low_priority
+#define __at(adresse)
+#define _delay(cycles)  ((void) 0)
+#define Nop()           ((void) 0)
+#define CLRWDT()        ((void) 0)
+
+struct xc_bits {
+    unsigned GIEH : 1, GIEL : 1;
+    unsigned nPOR : 1;
+    unsigned EEPGD : 1, CFGS : 1, WREN : 1, WR : 1, RD : 1;
+    unsigned TXIE : 1;
+    unsigned USBIE : 1, USBIF : 1;
+    unsigned USBEN : 1, SUSPND : 1, PKTDIS : 1;
+    unsigned URSTIE : 1, TRNIE : 1, IDLEIE : 1, ACTVIE : 1, SOFIE : 1;
+    unsigned URSTIF : 1, TRNIF : 1, IDLEIF : 1, ACTVIF : 1, SOFIF : 1;
+};
+
+#define XC_REGISTRE(nom) \
+    volatile unsigned char nom; volatile struct xc_bits nom##bits;
+
+XC_REGISTRE(INTCON)
+XC_REGISTRE(PIE1)
+XC_REGISTRE(PIE2)
+XC_REGISTRE(PIR2)
+XC_REGISTRE(TXREG)
+XC_REGISTRE(RCON)
+XC_REGISTRE(EECON1)
+XC_REGISTRE(EECON2)
+XC_REGISTRE(EEADR)
+XC_REGISTRE(EEDATA)
+XC_REGISTRE(UCON)
+XC_REGISTRE(UCFG)
+XC_REGISTRE(USTAT)
+XC_REGISTRE(UADDR)
+XC_REGISTRE(UIR)
+XC_REGISTRE(UIE)
+XC_REGISTRE(UEP0)
+XC_REGISTRE(UEP1)
+XC_REGISTRE(UEP2)
+
+#endif